@@ -0,0 +1,458 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "benchmark.h"
+
+#include <kdbindings/binding.h>
+#include <kdbindings/genindex_array.h>
+#include <kdbindings/homogeneous_signal.h>
+#include <kdbindings/intrusive_signal.h>
+#include <kdbindings/node_timeseries.h>
+#include <kdbindings/parallel_emission.h>
+#include <kdbindings/persistent_containers.h>
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+#include <kdbindings/static_connections.h>
+#include <kdbindings/thread_pool.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace KDBindings;
+using namespace KDBindingsBenchmarks;
+
+namespace {
+
+// The hand-written baselines that the abstractions of KDBindings are compared against.
+
+void callFunctionPointers(State &state, std::size_t slotCount)
+{
+    struct Slot {
+        void (*function)(void *, int);
+        void *context;
+    };
+
+    std::int64_t sum = 0;
+    std::vector<Slot> slots(slotCount, Slot{ [](void *context, int value) { *static_cast<std::int64_t *>(context) += value; }, &sum });
+    doNotOptimize(slots.data());
+
+    state.measure([&] {
+        for (const auto &slot : slots) {
+            slot.function(slot.context, 1);
+        }
+    });
+    doNotOptimize(sum);
+}
+
+void callStdFunctions(State &state, std::size_t slotCount)
+{
+    std::int64_t sum = 0;
+    std::vector<std::function<void(int)>> slots(slotCount, [&sum](int value) { sum += value; });
+    doNotOptimize(slots.data());
+
+    state.measure([&] {
+        for (const auto &slot : slots) {
+            slot(1);
+        }
+    });
+    doNotOptimize(sum);
+}
+
+class IntObserver
+{
+public:
+    virtual ~IntObserver() = default;
+    virtual void valueChanged(int value) = 0;
+};
+
+class ObservableInt
+{
+public:
+    void addObserver(IntObserver *observer)
+    {
+        m_observers.push_back(observer);
+    }
+
+    void set(int value)
+    {
+        if (value == m_value) {
+            return;
+        }
+        m_value = value;
+        for (auto *observer : m_observers) {
+            observer->valueChanged(value);
+        }
+    }
+
+    int get() const
+    {
+        return m_value;
+    }
+
+private:
+    int m_value = 0;
+    std::vector<IntObserver *> m_observers;
+};
+
+void setObservableInt(State &state)
+{
+    struct SumObserver : IntObserver {
+        void valueChanged(int value) override
+        {
+            sum += value;
+        }
+        std::int64_t sum = 0;
+    } observer;
+
+    ObservableInt observable;
+    observable.addObserver(&observer);
+    doNotOptimize(&observable);
+
+    int value = 0;
+    state.measure([&] { observable.set(++value); });
+    doNotOptimize(observer.sum);
+}
+
+// The expression of the binding benchmarks, updated directly by the code that changes its input.
+void evaluateDirectly(State &state)
+{
+    int a = 0;
+    int b = 1;
+    int result = 0;
+    doNotOptimize(b);
+
+    int value = 0;
+    state.measure([&] {
+        a = ++value;
+        result = a + b * 2;
+        doNotOptimize(result);
+    });
+}
+
+void emitSignal(State &state, std::size_t slotCount)
+{
+    Signal<int> signal;
+    std::int64_t sum = 0;
+    std::vector<ScopedConnection> connections;
+    for (std::size_t i = 0; i < slotCount; ++i) {
+        connections.emplace_back(signal.connect([&sum](int value) { sum += value; }));
+    }
+
+    state.measure([&] { signal.emit(1); });
+    doNotOptimize(sum);
+}
+
+struct Producer {
+    Signal<int> produced;
+};
+
+struct Consumer {
+    void consume(int value)
+    {
+        sum += value;
+    }
+    std::int64_t sum = 0;
+};
+
+void emitStaticConnection(State &state)
+{
+    Producer producer;
+    Consumer consumer;
+    StaticConnectionTable<StaticConnection<&Producer::produced, &Consumer::consume>> wiring(producer, consumer);
+
+    // Without dynamic connections, the whole emission may be inlined, so keep the sum observable.
+    state.measure([&] {
+        wiring.emit<&Producer::produced>(1);
+        doNotOptimize(consumer.sum);
+    });
+}
+
+// The same slots as in emitSignal(), but as a functor class that HomogeneousSignal stores by value.
+struct SumSlot {
+    void operator()(int value)
+    {
+        *sum += value;
+    }
+    std::int64_t *sum;
+};
+
+void emitHomogeneousSignal(State &state, std::size_t slotCount)
+{
+    HomogeneousSignal<SumSlot, int> signal;
+    std::int64_t sum = 0;
+    std::vector<ScopedConnection> connections;
+    for (std::size_t i = 0; i < slotCount; ++i) {
+        connections.emplace_back(signal.connect(SumSlot{ &sum }));
+    }
+
+    state.measure([&] {
+        signal.emit(1);
+        doNotOptimize(sum);
+    });
+}
+
+// A Consumer that embeds the storage of its connection.
+struct HookedConsumer : Consumer {
+    SlotHook<int> hook;
+};
+
+void emitIntrusiveSignal(State &state, std::size_t slotCount)
+{
+    IntrusiveSignal<int> signal;
+    std::vector<HookedConsumer> consumers(slotCount);
+    for (auto &consumer : consumers) {
+        signal.connect<&Consumer::consume>(consumer.hook, consumer);
+    }
+
+    state.measure([&] {
+        signal.emit(1);
+        doNotOptimize(consumers.front().sum);
+    });
+}
+
+void emitFragmentedSignal(State &state, std::size_t slotCount)
+{
+    // Every other connection is disconnected, leaving holes in the connection array.
+    Signal<int> signal;
+    std::int64_t sum = 0;
+    std::vector<ConnectionHandle> handles;
+    for (std::size_t i = 0; i < slotCount * 2; ++i) {
+        handles.push_back(signal.connect([&sum](int value) { sum += value; }));
+    }
+    for (std::size_t i = 0; i < handles.size(); i += 2) {
+        handles[i].disconnect();
+    }
+
+    state.measure([&] { signal.emit(1); });
+    doNotOptimize(sum);
+}
+
+// Slots that each take a few microseconds, so the emission can profit from running them concurrently.
+void emitHeavySignal(State &state, ThreadPool *pool)
+{
+    Signal<double> signal;
+    std::vector<ScopedConnection> connections;
+    for (int i = 0; i < 64; ++i) {
+        connections.emplace_back(signal.connect([](double value) {
+            for (int j = 0; j < 2000; ++j) {
+                value = value * 1.0000001 + 0.5;
+            }
+            doNotOptimize(value);
+        }));
+    }
+
+    if (pool) {
+        state.measure([&] { emitParallel(signal, *pool, 1.0); });
+    } else {
+        state.measure([&] { signal.emit(1.0); });
+    }
+}
+
+void connectDisconnect(State &state)
+{
+    Signal<int> signal;
+    state.measure([&] {
+        auto handle = signal.connect([](int) { });
+        handle.disconnect();
+    });
+}
+
+void connectDisconnectIntrusive(State &state)
+{
+    IntrusiveSignal<int> signal;
+    HookedConsumer consumer;
+    doNotOptimize(&consumer);
+    state.measure([&] {
+        signal.connect<&Consumer::consume>(consumer.hook, consumer);
+        consumer.hook.disconnect();
+        doNotOptimize(&signal);
+    });
+}
+
+void genindexInsertErase(State &state)
+{
+    Private::GenerationalIndexArray<int> array;
+    std::vector<Private::GenerationalIndex> indices(64);
+    state.measure([&] {
+        for (auto &index : indices) {
+            index = array.insert(1);
+        }
+        for (const auto &index : indices) {
+            array.erase(index);
+        }
+    },
+                  indices.size());
+}
+
+void genindexIterate(State &state)
+{
+    Private::GenerationalIndexArray<int> array;
+    for (int i = 0; i < 1024; ++i) {
+        array.insert(int(i));
+    }
+
+    state.measure([&] {
+        std::int64_t sum = 0;
+        const auto size = array.entriesSize();
+        for (std::uint32_t i = 0; i < size; ++i) {
+            if (const auto index = array.indexAtEntry(i)) {
+                sum += *array.get(*index);
+            }
+        }
+        doNotOptimize(sum);
+    },
+                  array.entriesSize());
+}
+
+void setObservedProperty(State &state)
+{
+    Property<int> property(0);
+    std::int64_t sum = 0;
+    ScopedConnection connection = property.valueChanged().connect([&sum](int value) { sum += value; });
+
+    int value = 0;
+    state.measure([&] { property = ++value; });
+    doNotOptimize(sum);
+}
+
+// Replaces one entry of a large map held by a Property, keeping the previous value as a snapshot.
+template<typename Map, typename Assign>
+void updateLargeMap(State &state, Map initial, Assign assign)
+{
+    Property<Map> property(std::move(initial));
+    Map snapshot;
+    ScopedConnection connection = property.valueAboutToChange().connect([&snapshot](const Map &oldValue, const Map &) { snapshot = oldValue; });
+
+    int value = 0;
+    state.measure([&] {
+        ++value;
+        assign(property, value % 100000, value);
+    });
+    doNotOptimize(snapshot);
+}
+
+void updateStdMap(State &state)
+{
+    std::map<int, int> initial;
+    for (int i = 0; i < 100000; ++i) {
+        initial.emplace(i, 0);
+    }
+    updateLargeMap(state, std::move(initial), [](Property<std::map<int, int>> &property, int key, int value) {
+        auto map = property.get();
+        map[key] = value;
+        property = std::move(map);
+    });
+}
+
+void updatePersistentMap(State &state)
+{
+    PersistentMap<int, int> initial;
+    for (int i = 0; i < 100000; ++i) {
+        initial = initial.set(i, 0);
+    }
+    updateLargeMap(state, std::move(initial), [](Property<PersistentMap<int, int>> &property, int key, int value) {
+        property = property.get().set(key, value);
+    });
+}
+
+void evaluateImmediateBinding(State &state)
+{
+    Property<int> a(0);
+    Property<int> b(1);
+    auto result = makeBoundProperty(a + b * 2);
+
+    int value = 0;
+    state.measure([&] { a = ++value; });
+    doNotOptimize(result.get());
+}
+
+void evaluateDeferredBinding(State &state)
+{
+    auto evaluator = BindingEvaluator{};
+    Property<int> a(0);
+    Property<int> b(1);
+    auto result = makeBoundProperty(evaluator, a + b * 2);
+
+    int value = 0;
+    state.measure([&] {
+        a = ++value;
+        evaluator.evaluateAll();
+    });
+    doNotOptimize(result.get());
+}
+
+void updateTimeSeries(State &state, std::size_t windowSamples)
+{
+    // A fake clock that advances by one millisecond per change keeps the window at a fixed size.
+    auto now = std::chrono::steady_clock::time_point();
+    auto scheduler = std::make_shared<TimerScheduler>(std::chrono::milliseconds(1), [&now]() { return now; });
+
+    Property<double> value(0.0);
+    auto average = makeBoundProperty(movingAverage(value, std::chrono::milliseconds(windowSamples), scheduler, windowSamples + 1));
+    auto maximum = makeBoundProperty(windowMax(value, std::chrono::milliseconds(windowSamples), scheduler, windowSamples + 1));
+
+    double next = 0.0;
+    state.measure([&] {
+        now += std::chrono::milliseconds(1);
+        value = next;
+        next = next > 1000.0 ? 0.0 : next + 1.5;
+    });
+    doNotOptimize(average.get());
+    doNotOptimize(maximum.get());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Harness harness;
+
+    for (std::size_t slotCount : { 1, 8, 64 }) {
+        const std::string slots = std::to_string(slotCount) + " slots";
+        harness.add("Baseline/function pointers/" + slots, [slotCount](State &state) { callFunctionPointers(state, slotCount); });
+        harness.add("Baseline/std::function/" + slots, [slotCount](State &state) { callStdFunctions(state, slotCount); },
+                    { "Baseline/function pointers/" + slots });
+        harness.add("Signal::emit/" + slots, [slotCount](State &state) { emitSignal(state, slotCount); },
+                    { "Baseline/function pointers/" + slots, "Baseline/std::function/" + slots });
+        harness.add("HomogeneousSignal::emit/" + slots, [slotCount](State &state) { emitHomogeneousSignal(state, slotCount); },
+                    { "Baseline/function pointers/" + slots, "Signal::emit/" + slots });
+        harness.add("IntrusiveSignal::emit/" + slots, [slotCount](State &state) { emitIntrusiveSignal(state, slotCount); },
+                    { "Baseline/function pointers/" + slots, "Signal::emit/" + slots });
+    }
+    harness.add("StaticConnectionTable::emit/1 slots", emitStaticConnection,
+                { "Baseline/function pointers/1 slots", "Signal::emit/1 slots" });
+    harness.add("Signal::emit/64 slots, fragmented", [](State &state) { emitFragmentedSignal(state, 64); });
+    harness.add("Signal::emit/64 heavy slots", [](State &state) { emitHeavySignal(state, nullptr); });
+    harness.add("Signal::emitParallel/64 heavy slots", [](State &state) {
+        ThreadPool pool;
+        emitHeavySignal(state, &pool);
+    });
+    harness.add("Signal::connect+disconnect", connectDisconnect);
+    harness.add("IntrusiveSignal::connect+disconnect", connectDisconnectIntrusive, { "Signal::connect+disconnect" });
+    harness.add("GenerationalIndexArray/insert+erase", genindexInsertErase);
+    harness.add("GenerationalIndexArray/iterate", genindexIterate);
+    harness.add("Baseline/observer interface", setObservableInt);
+    harness.add("Property::set/observed", setObservedProperty, { "Baseline/observer interface", "Signal::emit/1 slots" });
+    harness.add("Property::set/std::map, 100k entries", updateStdMap);
+    harness.add("Property::set/PersistentMap, 100k entries", updatePersistentMap, { "Property::set/std::map, 100k entries" });
+    harness.add("Baseline/direct arithmetic", evaluateDirectly);
+    harness.add("Binding/immediate", evaluateImmediateBinding, { "Baseline/direct arithmetic", "Property::set/observed" });
+    harness.add("Binding/deferred", evaluateDeferredBinding, { "Baseline/direct arithmetic", "Binding/immediate" });
+    for (std::size_t windowSamples : { 16, 4096 }) {
+        harness.add("TimeSeries/update/" + std::to_string(windowSamples) + " samples", [windowSamples](State &state) { updateTimeSeries(state, windowSamples); });
+    }
+
+    return harness.run(argc, argv);
+}
@@ -0,0 +1,372 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include "perf_counters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace KDBindingsBenchmarks {
+
+/** Prevents the compiler from optimizing away the computation of the given value. */
+template<typename T>
+inline void doNotOptimize(T &&value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/** The measurements of a single benchmark case. */
+struct Result {
+    std::string name;
+    std::size_t iterations = 0;
+    std::size_t operationsPerIteration = 1;
+    double nanosecondsPerOperation = 0;
+    // Per operation, empty if the counter couldn't be read.
+    PerfCounters::Values counters;
+};
+
+/** The cost of a benchmark case relative to one of its baselines. */
+struct Overhead {
+    std::string baseline;
+    // The ratio of the time per operation of the case and of the baseline.
+    double time = 0;
+    // The ratio of the instructions per operation, empty if the counter couldn't be read.
+    std::optional<double> instructions;
+};
+
+/**
+ * @brief The state that is passed to a benchmark case.
+ *
+ * A benchmark case prepares everything it needs and then calls measure() with the operation
+ * to benchmark. Only the calls of the operation are timed and counted.
+ */
+class State
+{
+public:
+    State(std::string name, std::chrono::nanoseconds minimumTime, PerfCounters &counters)
+        : m_minimumTime(minimumTime), m_counters(counters)
+    {
+        m_result.name = std::move(name);
+    }
+
+    /**
+     * Calls the operation repeatedly and records its cost.
+     *
+     * The number of iterations is doubled until a run takes at least the minimum time.
+     * The hardware counters are only read for that final run.
+     *
+     * @param operationsPerIteration The number of operations that one call of the operation
+     * performs, e.g. the number of slots of an emitted Signal. All results are divided by it.
+     */
+    template<typename Operation>
+    void measure(Operation &&operation, std::size_t operationsPerIteration = 1)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::size_t iterations = 1;
+        while (true) {
+            m_counters.start();
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                operation();
+            }
+            const auto elapsed = Clock::now() - start;
+            const auto counters = m_counters.stop();
+
+            if (elapsed >= m_minimumTime || iterations >= (std::size_t(1) << 40)) {
+                const double operations = static_cast<double>(iterations * operationsPerIteration);
+                m_result.iterations = iterations;
+                m_result.operationsPerIteration = operationsPerIteration;
+                m_result.nanosecondsPerOperation = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / operations;
+                for (std::size_t c = 0; c < counters.size(); ++c) {
+                    if (counters[c]) {
+                        m_result.counters[c] = *counters[c] / operations;
+                    }
+                }
+                return;
+            }
+            iterations *= 2;
+        }
+    }
+
+    const Result &result() const noexcept
+    {
+        return m_result;
+    }
+
+private:
+    std::chrono::nanoseconds m_minimumTime;
+    PerfCounters &m_counters;
+    Result m_result;
+};
+
+/**
+ * @brief A minimal benchmark harness.
+ *
+ * Benchmark cases are registered with add() and executed by run(), which understands these
+ * command line arguments:
+ *   --filter=<text>   Only run cases whose name contains the text.
+ *   --json=<file>     Write the results as JSON to the file ("-" for stdout).
+ *   --min-time=<ms>   The minimum duration of the measured run of every case, default 100.
+ *   --no-counters     Don't read the hardware performance counters.
+ *
+ * A summary table is always written to stderr.
+ *
+ * A case can name other cases as its baselines, e.g. a hand-written equivalent of the same
+ * operation. Its cost is then also reported as a ratio to the cost of each baseline, which tracks
+ * the overhead of an abstraction independently of the machine the benchmarks run on.
+ * Naming the next lower layer of an abstraction as an additional baseline shows which layer
+ * is responsible for the overhead.
+ * Baselines of the selected cases are always run, even if the filter doesn't match them.
+ */
+class Harness
+{
+public:
+    using Benchmark = std::function<void(State &)>;
+
+    void add(std::string name, Benchmark benchmark, std::vector<std::string> baselines = {})
+    {
+        m_benchmarks.push_back({ std::move(name), std::move(benchmark), std::move(baselines) });
+    }
+
+    int run(int argc, char **argv)
+    {
+        std::string filter;
+        std::string jsonFile;
+        std::chrono::milliseconds minimumTime(100);
+        bool useCounters = true;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument(argv[i]);
+            if (argument.rfind("--filter=", 0) == 0) {
+                filter = argument.substr(9);
+            } else if (argument.rfind("--json=", 0) == 0) {
+                jsonFile = argument.substr(7);
+            } else if (argument.rfind("--min-time=", 0) == 0) {
+                minimumTime = std::chrono::milliseconds(std::atol(argument.c_str() + 11));
+            } else if (argument == "--no-counters") {
+                useCounters = false;
+            } else {
+                std::cerr << "Unknown argument: " << argument << "\n";
+                return 1;
+            }
+        }
+
+        PerfCounters counters(useCounters);
+        if (!counters.isAvailable()) {
+            std::cerr << "Hardware counters unavailable (" << counters.unavailableReason() << "), reporting timings only\n";
+        }
+
+        std::vector<bool> selected(m_benchmarks.size(), false);
+        for (std::size_t b = 0; b < m_benchmarks.size(); ++b) {
+            if (filter.empty() || m_benchmarks[b].name.find(filter) != std::string::npos) {
+                select(b, selected);
+            }
+        }
+
+        std::vector<Result> results;
+        for (std::size_t b = 0; b < m_benchmarks.size(); ++b) {
+            if (!selected[b]) {
+                continue;
+            }
+            State state(m_benchmarks[b].name, minimumTime, counters);
+            m_benchmarks[b].benchmark(state);
+            results.push_back(state.result());
+            printRow(state.result());
+        }
+
+        const auto overheads = computeOverheads(results);
+        printOverheads(results, overheads);
+
+        if (!jsonFile.empty()) {
+            const std::string json = toJson(results, overheads, counters);
+            if (jsonFile == "-") {
+                std::cout << json;
+            } else {
+                std::ofstream file(jsonFile);
+                file << json;
+                if (!file) {
+                    std::cerr << "Failed to write " << jsonFile << "\n";
+                    return 1;
+                }
+            }
+        }
+        return 0;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        Benchmark benchmark;
+        std::vector<std::string> baselines;
+    };
+
+    // Selects the case and, recursively, its baselines.
+    void select(std::size_t b, std::vector<bool> &selected) const
+    {
+        if (selected[b]) {
+            return;
+        }
+        selected[b] = true;
+        for (const auto &baseline : m_benchmarks[b].baselines) {
+            for (std::size_t other = 0; other < m_benchmarks.size(); ++other) {
+                if (m_benchmarks[other].name == baseline) {
+                    select(other, selected);
+                }
+            }
+        }
+    }
+
+    const Entry *entry(const std::string &name) const
+    {
+        for (const auto &benchmark : m_benchmarks) {
+            if (benchmark.name == name) {
+                return &benchmark;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the overheads of every result, in the same order as the results.
+    std::vector<std::vector<Overhead>> computeOverheads(const std::vector<Result> &results) const
+    {
+        std::vector<std::vector<Overhead>> overheads(results.size());
+        for (std::size_t r = 0; r < results.size(); ++r) {
+            for (const auto &baselineName : entry(results[r].name)->baselines) {
+                for (const auto &baseline : results) {
+                    if (baseline.name != baselineName || baseline.nanosecondsPerOperation <= 0) {
+                        continue;
+                    }
+                    Overhead overhead;
+                    overhead.baseline = baselineName;
+                    overhead.time = results[r].nanosecondsPerOperation / baseline.nanosecondsPerOperation;
+                    const auto &instructions = results[r].counters[PerfCounters::Instructions];
+                    const auto &baselineInstructions = baseline.counters[PerfCounters::Instructions];
+                    if (instructions && baselineInstructions && *baselineInstructions > 0) {
+                        overhead.instructions = *instructions / *baselineInstructions;
+                    }
+                    overheads[r].push_back(std::move(overhead));
+                }
+            }
+        }
+        return overheads;
+    }
+
+    static void printOverheads(const std::vector<Result> &results, const std::vector<std::vector<Overhead>> &overheads)
+    {
+        bool header = false;
+        char line[256];
+        for (std::size_t r = 0; r < results.size(); ++r) {
+            for (const auto &overhead : overheads[r]) {
+                if (!header) {
+                    std::cerr << "\nOverhead relative to baselines:\n";
+                    header = true;
+                }
+                std::snprintf(line, sizeof(line), "%-48s %8.3gx time", results[r].name.c_str(), overhead.time);
+                std::cerr << line;
+                if (overhead.instructions) {
+                    std::snprintf(line, sizeof(line), " %8.3gx instructions", *overhead.instructions);
+                    std::cerr << line;
+                }
+                std::cerr << "  vs " << overhead.baseline << "\n";
+            }
+        }
+    }
+
+    static void printRow(const Result &result)
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-48s %12.2f ns/op", result.name.c_str(), result.nanosecondsPerOperation);
+        std::cerr << line;
+        for (std::size_t c = 0; c < result.counters.size(); ++c) {
+            if (result.counters[c]) {
+                std::snprintf(line, sizeof(line), "  %s=%.2f", PerfCounters::name(static_cast<PerfCounters::Counter>(c)), *result.counters[c]);
+                std::cerr << line;
+            }
+        }
+        std::cerr << "\n";
+    }
+
+    static std::string toJson(const std::vector<Result> &results, const std::vector<std::vector<Overhead>> &overheads, const PerfCounters &counters)
+    {
+        std::ostringstream json;
+        json.precision(6);
+        json << "{\n  \"context\": {\n";
+        json << "    \"perfCounters\": " << (counters.isAvailable() ? "true" : "false");
+        if (!counters.isAvailable()) {
+            json << ",\n    \"perfCountersUnavailableReason\": \"" << counters.unavailableReason() << "\"";
+        }
+        json << "\n  },\n  \"benchmarks\": [";
+
+        for (std::size_t r = 0; r < results.size(); ++r) {
+            const Result &result = results[r];
+            json << (r == 0 ? "\n" : ",\n");
+            json << "    {\n";
+            json << "      \"name\": \"" << result.name << "\",\n";
+            json << "      \"iterations\": " << result.iterations << ",\n";
+            json << "      \"operationsPerIteration\": " << result.operationsPerIteration << ",\n";
+            json << "      \"nsPerOperation\": " << result.nanosecondsPerOperation << ",\n";
+            json << "      \"counters\": {";
+            bool first = true;
+            for (std::size_t c = 0; c < result.counters.size(); ++c) {
+                json << (first ? "" : ",") << "\n        \"" << PerfCounters::name(static_cast<PerfCounters::Counter>(c)) << "\": ";
+                if (result.counters[c]) {
+                    json << *result.counters[c];
+                } else {
+                    json << "null";
+                }
+                first = false;
+            }
+            const auto &cycles = result.counters[PerfCounters::Cycles];
+            const auto &instructions = result.counters[PerfCounters::Instructions];
+            json << ",\n        \"instructionsPerCycle\": ";
+            if (cycles && instructions && *cycles > 0) {
+                json << *instructions / *cycles;
+            } else {
+                json << "null";
+            }
+            json << "\n      },\n      \"overhead\": [";
+            for (std::size_t o = 0; o < overheads[r].size(); ++o) {
+                const Overhead &overhead = overheads[r][o];
+                json << (o == 0 ? "\n" : ",\n");
+                json << "        { \"baseline\": \"" << overhead.baseline << "\", \"time\": " << overhead.time << ", \"instructions\": ";
+                if (overhead.instructions) {
+                    json << *overhead.instructions;
+                } else {
+                    json << "null";
+                }
+                json << " }";
+            }
+            json << (overheads[r].empty() ? "]" : "\n      ]") << "\n    }";
+        }
+        json << "\n  ]\n}\n";
+        return json.str();
+    }
+
+    std::vector<Entry> m_benchmarks;
+};
+
+} // namespace KDBindingsBenchmarks
@@ -0,0 +1,197 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace KDBindingsBenchmarks {
+
+/**
+ * @brief Reads hardware performance counters of the calling thread.
+ *
+ * On Linux, the counters are opened with perf_event_open. Every counter is opened on its own,
+ * so that a counter that is not supported by the CPU (or the virtual machine) doesn't prevent
+ * the others from being read.
+ *
+ * Counting may be denied entirely, e.g. by /proc/sys/kernel/perf_event_paranoid or inside of
+ * containers. In that case, and on other platforms, isAvailable() returns false and all counter
+ * values are empty, so benchmarks can still report their wall-clock timings.
+ */
+class PerfCounters
+{
+public:
+    enum Counter {
+        Cycles,
+        Instructions,
+        L1DataCacheMisses,
+        LastLevelCacheMisses,
+        BranchMisses,
+        CounterCount
+    };
+
+    // The values of all counters, scaled if the kernel had to multiplex them.
+    using Values = std::array<std::optional<double>, CounterCount>;
+
+    static const char *name(Counter counter)
+    {
+        switch (counter) {
+        case Cycles:
+            return "cycles";
+        case Instructions:
+            return "instructions";
+        case L1DataCacheMisses:
+            return "l1dMisses";
+        case LastLevelCacheMisses:
+            return "llcMisses";
+        case BranchMisses:
+            return "branchMisses";
+        default:
+            return "";
+        }
+    }
+
+    explicit PerfCounters(bool enabled = true)
+    {
+        m_fds.fill(-1);
+        if (!enabled) {
+            m_unavailableReason = "disabled";
+            return;
+        }
+
+#if defined(__linux__)
+        constexpr auto cacheEvent = [](std::uint64_t cache, std::uint64_t result) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+        };
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, CounterCount> events{ {
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+                { PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+                { PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+                { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        } };
+
+        int firstError = 0;
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // Count the calling thread on any CPU.
+            const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fd < 0) {
+                if (firstError == 0) {
+                    firstError = errno;
+                }
+                continue;
+            }
+            m_fds[i] = static_cast<int>(fd);
+        }
+
+        if (!isAvailable()) {
+            m_unavailableReason = std::string("perf_event_open failed: ") + std::strerror(firstError);
+        }
+#else
+        m_unavailableReason = "not supported on this platform";
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#if defined(__linux__)
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /** Returns whether at least one counter could be opened. */
+    bool isAvailable() const noexcept
+    {
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Returns why no counters are available, or an empty string if they are. */
+    const std::string &unavailableReason() const noexcept
+    {
+        return m_unavailableReason;
+    }
+
+    /** Resets and starts all counters. */
+    void start()
+    {
+#if defined(__linux__)
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /** Stops all counters and returns the events counted since start(). */
+    Values stop()
+    {
+        Values values;
+#if defined(__linux__)
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (std::size_t i = 0; i < m_fds.size(); ++i) {
+            if (m_fds[i] < 0) {
+                continue;
+            }
+            // value, time enabled, time running
+            std::uint64_t data[3] = { 0, 0, 0 };
+            if (read(m_fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+                continue;
+            }
+            values[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+#endif
+        return values;
+    }
+
+private:
+    std::array<int, CounterCount> m_fds;
+    std::string m_unavailableReason;
+};
+
+} // namespace KDBindingsBenchmarks
@@ -0,0 +1,227 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace KDBindings {
+
+namespace Private {
+
+struct BidirectionalBindingStateBase {
+    virtual ~BidirectionalBindingStateBase() = default;
+};
+
+template<typename A, typename B, typename Forward, typename Backward>
+struct BidirectionalBindingState : BidirectionalBindingStateBase {
+    BidirectionalBindingState(Property<A> &first, Property<B> &second, Forward &&forwardFunction, Backward &&backwardFunction)
+        : a(&first), b(&second), forward(std::move(forwardFunction)), backward(std::move(backwardFunction))
+    {
+        // The change Signals move along with the Properties, so we only need to follow the moves.
+        aMovedConnection = first.m_moved.connect([this](Property<A> &property) { propertyMoved(a, property); });
+        bMovedConnection = second.m_moved.connect([this](Property<B> &property) { propertyMoved(b, property); });
+    }
+
+    template<typename T>
+    static void propertyMoved(Property<T> *&current, Property<T> &property)
+    {
+        if (&property != current) {
+            current = &property;
+        } else {
+            // Another Property was moved into ours, which replaced the change Signals we were connected to.
+            current = nullptr;
+        }
+    }
+
+    // Sets the flag while a change is propagated, so the resulting change of the other
+    // Property isn't propagated back.
+    struct PropagationGuard {
+        explicit PropagationGuard(bool &flag)
+            : m_flag(flag)
+        {
+            m_flag = true;
+        }
+        ~PropagationGuard()
+        {
+            m_flag = false;
+        }
+        bool &m_flag;
+    };
+
+    void propagateForward(const A &value)
+    {
+        if (propagating || !b || b->hasBinding()) {
+            return;
+        }
+        PropagationGuard guard(propagating);
+        b->set(std::invoke(forward, value));
+    }
+
+    void propagateBackward(const B &value)
+    {
+        if (propagating || !a || a->hasBinding()) {
+            return;
+        }
+        PropagationGuard guard(propagating);
+        a->set(std::invoke(backward, value));
+    }
+
+    Property<A> *a;
+    Property<B> *b;
+    Forward forward;
+    Backward backward;
+    bool propagating = false;
+
+    ScopedConnection aMovedConnection;
+    ScopedConnection bMovedConnection;
+    ScopedConnection aDestroyedConnection;
+    ScopedConnection bDestroyedConnection;
+    ScopedConnection aChangedConnection;
+    ScopedConnection bChangedConnection;
+};
+
+} // namespace Private
+
+class BidirectionalBinding;
+
+template<typename A, typename B, typename Forward, typename Backward>
+KDBINDINGS_WARN_UNUSED BidirectionalBinding bindBidirectional(Property<A> &a, Property<B> &b, Forward &&forward, Backward &&backward);
+
+/**
+ * @brief A BidirectionalBinding keeps two Properties in sync in both directions.
+ *
+ * @warning Bidirectional bindings are experimental and may be removed or changed in the future.
+ *
+ * It is created by KDBindings::bindBidirectional() and stops synchronizing the Properties when it
+ * is destructed. Both Properties keep their current values.
+ */
+class BidirectionalBinding
+{
+public:
+    /** A default constructed BidirectionalBinding doesn't synchronize anything. */
+    BidirectionalBinding() = default;
+
+    /** A BidirectionalBinding can not be copied. */
+    BidirectionalBinding(const BidirectionalBinding &) = delete;
+    /** A BidirectionalBinding can not be copied. */
+    BidirectionalBinding &operator=(const BidirectionalBinding &) = delete;
+
+    /** A BidirectionalBinding can be moved. */
+    BidirectionalBinding(BidirectionalBinding &&) noexcept = default;
+    /** A BidirectionalBinding can be moved. Any synchronization of this instance is stopped. */
+    BidirectionalBinding &operator=(BidirectionalBinding &&) noexcept = default;
+
+    /** Stops synchronizing the Properties. */
+    ~BidirectionalBinding() = default;
+
+    /** Returns whether this BidirectionalBinding currently synchronizes two Properties. */
+    bool isActive() const noexcept
+    {
+        return m_state != nullptr;
+    }
+
+private:
+    template<typename A, typename B, typename Forward, typename Backward>
+    friend BidirectionalBinding bindBidirectional(Property<A> &, Property<B> &, Forward &&, Backward &&);
+
+    explicit BidirectionalBinding(std::unique_ptr<Private::BidirectionalBindingStateBase> &&state)
+        : m_state(std::move(state))
+    {
+    }
+
+    std::unique_ptr<Private::BidirectionalBindingStateBase> m_state;
+};
+
+/**
+ * @brief Keeps two Properties in sync in both directions, converting the values with the given functions.
+ *
+ * @warning Bidirectional bindings are experimental and may be removed or changed in the future.
+ *
+ * Whenever a changes, forward(a) is assigned to b, and whenever b changes, backward(b) is assigned to a.
+ * The change that is caused by the propagation is not propagated back, so every external change
+ * is converted exactly once, and each Property emits valueChanged() at most once per change.
+ * This also keeps lossy conversions stable: if backward(forward(x)) differs from x, a keeps the value x.
+ *
+ * When the binding is created, b is set to forward(a).
+ *
+ * A Property that holds a Binding can't be written to. In this case, changes are only propagated
+ * away from it, and it isn't affected by changes of the other Property. This also applies if the
+ * Binding is assigned after the bidirectional binding was created.
+ * If b holds a Binding when the bidirectional binding is created, a is set to backward(b) instead.
+ *
+ * If one of the Properties is moved, the binding follows it to its new location.
+ * If one of the Properties is destroyed, or another Property is move assigned to it,
+ * the synchronization stops.
+ *
+ * Example:
+ * @code
+ * auto sync = bindBidirectional(model.celsius, view.fahrenheit,
+ *                               [](double c) { return c * 9 / 5 + 32; },
+ *                               [](double f) { return (f - 32) * 5 / 9; });
+ * @endcode
+ *
+ * @param a The first Property, whose value is used when the binding is created.
+ * @param b The second Property.
+ * @param forward Converts a value of a into a value of b.
+ * @param backward Converts a value of b into a value of a.
+ * @return A BidirectionalBinding that stops the synchronization when it is destructed.
+ * @throw ReadOnlyProperty If both Properties hold a Binding.
+ */
+template<typename A, typename B, typename Forward, typename Backward>
+KDBINDINGS_WARN_UNUSED BidirectionalBinding bindBidirectional(Property<A> &a, Property<B> &b, Forward &&forward, Backward &&backward)
+{
+    static_assert(std::is_convertible_v<std::invoke_result_t<std::decay_t<Forward> &, const A &>, B>,
+                  "The forward function must convert a value of the first Property into a value of the second Property");
+    static_assert(std::is_convertible_v<std::invoke_result_t<std::decay_t<Backward> &, const B &>, A>,
+                  "The backward function must convert a value of the second Property into a value of the first Property");
+
+    if (a.hasBinding() && b.hasBinding()) {
+        throw ReadOnlyProperty{ "Both Properties of a bidirectional binding hold a Binding" };
+    }
+
+    using State = Private::BidirectionalBindingState<A, B, std::decay_t<Forward>, std::decay_t<Backward>>;
+    auto state = std::make_unique<State>(a, b, std::decay_t<Forward>(std::forward<Forward>(forward)), std::decay_t<Backward>(std::forward<Backward>(backward)));
+    auto *statePtr = state.get();
+
+    state->aDestroyedConnection = a.destroyed().connect([statePtr]() { statePtr->a = nullptr; });
+    state->bDestroyedConnection = b.destroyed().connect([statePtr]() { statePtr->b = nullptr; });
+    state->aChangedConnection = a.valueChanged().connect([statePtr](const A &value) { statePtr->propagateForward(value); });
+    state->bChangedConnection = b.valueChanged().connect([statePtr](const B &value) { statePtr->propagateBackward(value); });
+
+    if (b.hasBinding()) {
+        statePtr->propagateBackward(b.get());
+    } else {
+        statePtr->propagateForward(a.get());
+    }
+
+    return BidirectionalBinding(std::move(state));
+}
+
+/**
+ * @brief Keeps two Properties of the same type in sync in both directions.
+ *
+ * @warning Bidirectional bindings are experimental and may be removed or changed in the future.
+ *
+ * This is the same as bindBidirectional() with conversion functions that return the value unchanged.
+ */
+template<typename T>
+KDBINDINGS_WARN_UNUSED BidirectionalBinding bindBidirectional(Property<T> &a, Property<T> &b)
+{
+    auto identity = [](const T &value) -> const T & { return value; };
+    return bindBidirectional(a, b, identity, identity);
+}
+
+} // namespace KDBindings
@@ -14,6 +14,7 @@
 #include <kdbindings/node.h>
 #include <kdbindings/node_operators.h>
 #include <kdbindings/node_functions.h>
+#include <kdbindings/node_strings.h>
 #include <kdbindings/make_node.h>
 #include <kdbindings/binding_evaluator.h>
 #include <kdbindings/property_updater.h>
@@ -50,6 +51,9 @@ public:
     {
         m_bindingId = m_evaluator.insert(this);
         m_rootNode.setParent(this);
+#ifdef KDBINDINGS_ENABLE_MEMORY_TRACKING
+        m_memoryTracker.update(Binding::memoryUsage().totalBytes());
+#endif
     }
 
     /** Destructs the Binding by deregistering it from its evaluator. */
@@ -84,13 +88,131 @@ public:
     /** Returns the current value of the Binding. */
     T get() const override { return m_rootNode.evaluate(); }
 
-    /** Re-evaluates the value of the Binding and notifies all dependants of the change. */
+    /**
+     * Re-evaluates the value of the Binding and notifies all dependants of the change.
+     *
+     * If the Binding suspends when unobserved and nobody observes its Property,
+     * the evaluation is postponed until the Property is observed again.
+     */
     void evaluate()
     {
-        T value = m_rootNode.evaluate();
+        if (m_suspendWhenUnobserved && !m_isObserved()) {
+            m_suspended = true;
+            return;
+        }
+        update();
+    }
 
-        // Use this to update any associated property via the PropertyUpdater's update function
-        m_propertyUpdateFunction(std::move(value));
+    void setObservedFunction(std::function<bool()> const &isObserved) override
+    {
+        m_isObserved = isObserved;
+    }
+
+    /** Evaluates the Binding if an evaluation was postponed because its Property was unobserved. */
+    void catchUp() override
+    {
+        if (m_suspended) {
+            update();
+        }
+    }
+
+    /**
+     * @brief Sets whether the Binding skips evaluations while its Property is unobserved.
+     *
+     * @warning Suspending unobserved Bindings is experimental and may be removed or changed in the future.
+     *
+     * A Property is observed while slots are connected to its valueChanged() or valueAboutToChange()
+     * Signals, which includes other Bindings that depend on it.
+     * While the Property is unobserved, the Binding does not evaluate its expression when its
+     * inputs change, but only remembers that it is out of date.
+     * The nodes of the expression stay dirty in this case, so further changes of the inputs stop
+     * propagating at the first node and cost next to nothing.
+     *
+     * As soon as the Property is observed again, i.e. it is read or one of its change Signals is
+     * accessed, the Binding catches up with a single evaluation.
+     * Note that this means errors of the expression, e.g. a PropertyDestroyedError, are only
+     * thrown when the Property is read.
+     *
+     * This is off by default. Turning it off evaluates a postponed evaluation immediately.
+     */
+    void setSuspendWhenUnobserved(bool suspend)
+    {
+        m_suspendWhenUnobserved = suspend;
+        if (!suspend) {
+            catchUp();
+        }
+    }
+
+    /** Returns whether the Binding skips evaluations while its Property is unobserved. */
+    bool suspendsWhenUnobserved() const noexcept
+    {
+        return m_suspendWhenUnobserved;
+    }
+
+    /** Returns whether an evaluation is currently postponed because the Property is unobserved. */
+    bool isSuspended() const noexcept
+    {
+        return m_suspended;
+    }
+
+    /**
+     * @brief Makes the Binding refer to other source Properties, keeping its expression.
+     *
+     * The Properties referenced by the expression are replaced by the given Properties,
+     * in the order they appear in the expression.
+     * For example, a Binding created by `makeBinding(a + b * 2)` can be rebound using
+     * `rebind(c, d)`, after which it behaves like `makeBinding(c + d * 2)`.
+     *
+     * In comparison to assigning a new Binding to a Property, this keeps the node tree of the
+     * expression and the registration with the evaluator.
+     * Only the connections to the Signals of the source Properties are recreated.
+     * This makes rebinding well suited for recycling objects, e.g. delegates of a list view.
+     *
+     * Afterwards, the Binding is marked dirty, so an immediate mode Binding is re-evaluated once.
+     *
+     * @param sources The new source Properties, one for every Property in the expression.
+     * @throw std::invalid_argument If the number of Properties doesn't match the expression, or
+     * if the value type of a Property doesn't match the Property it replaces.
+     * In this case, the Binding is left unchanged.
+     */
+    template<typename... Ps>
+    void rebind(Ps &...sources)
+    {
+        static_assert(std::conjunction_v<Private::is_property<Ps>...>, "Bindings can only be rebound to Properties");
+
+        std::vector<Private::Dirtyable *> nodes;
+        m_rootNode.collectPropertyNodes(nodes);
+        if (nodes.size() != sizeof...(Ps)) {
+            throw std::invalid_argument("The number of Properties does not match the number of Properties in the Binding expression");
+        }
+
+        // Check all types first, so a failure doesn't leave the Binding half-rebound.
+        std::size_t i = 0;
+        const bool typesMatch = (... && (dynamic_cast<Private::PropertyNode<Private::bindable_value_type_t<Ps>> *>(nodes[i++]) != nullptr));
+        if (!typesMatch) {
+            throw std::invalid_argument("The type of a Property does not match the type of the Property it replaces in the Binding expression");
+        }
+
+        // Detach the tree while retargeting, so that an immediate Binding is only evaluated once.
+        m_rootNode.setParent(nullptr);
+        i = 0;
+        (static_cast<Private::PropertyNode<Private::bindable_value_type_t<Ps>> *>(nodes[i++])->retarget(sources), ...);
+        m_rootNode.setParent(this);
+
+        markDirty();
+    }
+
+    /**
+     * Reports the memory used by this Binding and the node tree of its expression.
+     *
+     * The memory used by the evaluator is shared between all of its Bindings
+     * and reported by BindingEvaluator::memoryUsage() instead.
+     */
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage = m_rootNode.memoryUsage();
+        usage.liveBytes += sizeof(Binding);
+        return usage;
     }
 
 protected:
@@ -105,6 +227,23 @@ protected:
     std::function<void(T &&)> m_propertyUpdateFunction = [](T &&) {};
     /** The id of the Binding, used for keeping track of the Binding in its evaluator. */
     int m_bindingId = -1;
+
+private:
+    void update()
+    {
+        m_suspended = false;
+        T value = m_rootNode.evaluate();
+
+        // Use this to update any associated property via the PropertyUpdater's update function
+        m_propertyUpdateFunction(std::move(value));
+    }
+
+    std::function<bool()> m_isObserved = []() { return true; };
+    bool m_suspendWhenUnobserved = false;
+    bool m_suspended = false;
+#ifdef KDBINDINGS_ENABLE_MEMORY_TRACKING
+    Private::MemoryTracker m_memoryTracker;
+#endif
 };
 
 /**
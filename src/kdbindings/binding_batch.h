@@ -0,0 +1,417 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <kdbindings/make_node.h>
+#include <kdbindings/memory_usage.h>
+#include <kdbindings/node.h>
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+namespace KDBindings {
+
+template<typename Func, typename Columns, typename Uniforms>
+class BindingBatch;
+
+/**
+ * @brief A BindingBatch evaluates the same expression for many rows of values, which are stored in columns.
+ *
+ * @warning BindingBatch is experimental and may be removed or changed in the future.
+ *
+ * When many objects have an identical Binding, e.g. `position = origin + velocity * t` for every
+ * entity of a simulation, every one of them has its own tree of nodes, its own Properties
+ * and its own Signals, and every evaluation walks a tree of virtual calls.
+ * A BindingBatch instead stores the inputs of all instances in one std::vector per input (the columns),
+ * and the results in another std::vector.
+ * The expression is a single function object that is called for every row that needs to be updated,
+ * in a plain loop over the columns, which the compiler can inline and often vectorize.
+ *
+ * Inputs that are shared by all rows, like the time `t` above, are passed as uniforms.
+ * Uniforms can be Properties, binding expressions or constants, just like the arguments of
+ * makeBoundProperty(). When a uniform changes, all rows become dirty.
+ * Changing the value of a column only marks that row as dirty.
+ *
+ * Like a Binding with a BindingEvaluator, a BindingBatch only updates its results when
+ * evaluate() is called. Afterwards, resultsChanged() is emitted once, with the indices of all rows
+ * whose result changed, so observers don't receive a notification per row.
+ *
+ * A BindingBatch can neither be copied nor moved, as the nodes of its uniforms refer to it.
+ *
+ * Example:
+ * @code
+ * Property<float> t(0.0f);
+ * auto positions = makeBindingBatch<Vec2, Vec2>([](Vec2 origin, Vec2 velocity, float t) { return origin + velocity * t; }, t);
+ * positions.addRow({ 0, 0 }, { 1, 2 });
+ * t = 1.0f;
+ * positions.evaluate(); // positions.result(0) == Vec2{ 1, 2 }
+ * @endcode
+ *
+ * @tparam Func The function that computes the result of a row. It is called with the values of all
+ *              columns of the row, followed by the values of all uniforms.
+ * @tparam Cs The types of the columns.
+ * @tparam Us The value types of the uniforms.
+ */
+template<typename Func, typename... Cs, typename... Us>
+class BindingBatch<Func, std::tuple<Cs...>, std::tuple<Us...>> : private Private::Dirtyable
+{
+public:
+    /** The type of the results. */
+    using ResultType = std::decay_t<std::invoke_result_t<Func &, const Cs &..., const Us &...>>;
+
+    /** The type of the column with index I. */
+    template<std::size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<Cs...>>;
+
+    /** Constructs an empty BindingBatch. Prefer using makeBindingBatch(). */
+    BindingBatch(Func func, Private::Node<Us> &&...uniforms)
+        : m_func(std::move(func)), m_uniforms(std::move(uniforms)...)
+    {
+        std::apply([this](auto &...nodes) { (nodes.setParent(this), ...); }, m_uniforms);
+    }
+
+    /** A BindingBatch cannot be copy constructed. */
+    BindingBatch(const BindingBatch &) = delete;
+    /** A BindingBatch cannot be copy assigned. */
+    BindingBatch &operator=(const BindingBatch &) = delete;
+    /** A BindingBatch cannot be move constructed. */
+    BindingBatch(BindingBatch &&) = delete;
+    /** A BindingBatch cannot be move assigned. */
+    BindingBatch &operator=(BindingBatch &&) = delete;
+
+    /** Returns the number of rows. */
+    std::size_t size() const noexcept
+    {
+        return m_results.size();
+    }
+
+    /** Reserves memory for the given number of rows in all columns. */
+    void reserve(std::size_t rows)
+    {
+        std::apply([rows](auto &...columns) { (columns.reserve(rows), ...); }, m_columns);
+        m_results.reserve(rows);
+        m_rowDirty.reserve(rows);
+    }
+
+    /**
+     * Appends a row with the given column values and returns its index.
+     *
+     * The result of the new row is computed immediately. This does not emit resultsChanged().
+     *
+     * @throw PropertyDestroyedError If a uniform refers to a Property that no longer exists.
+     */
+    std::size_t addRow(Cs... values)
+    {
+        const auto uniforms = evaluateUniforms();
+        ResultType result = std::apply([&](const auto &...uniformValues) { return m_func(values..., uniformValues...); }, uniforms);
+
+        appendColumns(std::index_sequence_for<Cs...>(), std::move(values)...);
+        m_results.push_back(std::move(result));
+        m_rowDirty.push_back(0);
+        return m_results.size() - 1;
+    }
+
+    /**
+     * Removes the given row by moving the last row into its place.
+     *
+     * This changes the index of the last row to the index of the removed row.
+     *
+     * @throw std::out_of_range If the row doesn't exist.
+     */
+    void removeRow(std::size_t row)
+    {
+        checkRow(row);
+        const std::size_t last = m_results.size() - 1;
+        if (row != last) {
+            swapRows(row, last, std::index_sequence_for<Cs...>());
+            if (m_rowDirty[row]) {
+                m_dirtyRows.push_back(row);
+            }
+        }
+        std::apply([](auto &...columns) { (columns.pop_back(), ...); }, m_columns);
+        m_results.pop_back();
+        m_rowDirty.pop_back();
+    }
+
+    /** Returns the values of the column with index I, for all rows. */
+    template<std::size_t I>
+    const std::vector<ColumnType<I>> &column() const noexcept
+    {
+        return std::get<I>(m_columns);
+    }
+
+    /** Returns the value of the column with index I in the given row. */
+    template<std::size_t I>
+    const ColumnType<I> &get(std::size_t row) const
+    {
+        checkRow(row);
+        return std::get<I>(m_columns)[row];
+    }
+
+    /**
+     * Sets the value of the column with index I in the given row, and marks the row as dirty
+     * if the value changed.
+     *
+     * @throw std::out_of_range If the row doesn't exist.
+     */
+    template<std::size_t I>
+    void set(std::size_t row, ColumnType<I> value)
+    {
+        checkRow(row);
+        auto &field = std::get<I>(m_columns)[row];
+        if (equal_to<ColumnType<I>>{}(field, value)) {
+            return;
+        }
+        field = std::move(value);
+        markRowDirty(row);
+    }
+
+    /**
+     * Calls the given function with the column with index I, so that all of its values can be changed
+     * at once, and marks all rows as dirty.
+     *
+     * The function must not change the size of the column.
+     */
+    template<std::size_t I, typename ModifyFunc>
+    void modifyColumn(ModifyFunc &&modify)
+    {
+        auto &values = std::get<I>(m_columns);
+        std::forward<ModifyFunc>(modify)(values);
+        if (values.size() != m_results.size()) {
+            throw std::logic_error("modifyColumn must not change the number of rows");
+        }
+        m_allDirty = true;
+    }
+
+    /** Returns the result of the given row, as of the last call to evaluate(). */
+    const ResultType &result(std::size_t row) const
+    {
+        checkRow(row);
+        return m_results[row];
+    }
+
+    /** Returns the results of all rows, as of the last call to evaluate(). */
+    const std::vector<ResultType> &results() const noexcept
+    {
+        return m_results;
+    }
+
+    /** Returns whether any row needs to be evaluated. */
+    bool isDirty() const noexcept
+    {
+        return m_allDirty || !m_dirtyRows.empty();
+    }
+
+    /**
+     * Computes the results of all dirty rows.
+     *
+     * If many rows are dirty, all rows are computed in a single loop over the columns, as that is
+     * faster than looking up the individual rows.
+     * Afterwards, resultsChanged() is emitted once if the result of any row changed.
+     *
+     * @return The number of rows whose result changed.
+     * @throw PropertyDestroyedError If a uniform refers to a Property that no longer exists.
+     */
+    std::size_t evaluate()
+    {
+        if (!isDirty()) {
+            return 0;
+        }
+
+        m_changedRows.clear();
+        const auto uniforms = evaluateUniforms();
+        if (m_allDirty || m_dirtyRows.size() * 4 >= m_results.size()) {
+            evaluateAllRows(uniforms, std::index_sequence_for<Cs...>());
+        } else {
+            evaluateDirtyRows(uniforms, std::index_sequence_for<Cs...>());
+        }
+
+        m_allDirty = false;
+        for (const auto row : m_dirtyRows) {
+            if (row < m_rowDirty.size()) {
+                m_rowDirty[row] = 0;
+            }
+        }
+        m_dirtyRows.clear();
+
+        if (!m_changedRows.empty()) {
+            m_resultsChanged.emit(m_changedRows);
+        }
+        return m_changedRows.size();
+    }
+
+    /**
+     * Returns a Signal that is emitted by evaluate() with the indices of the rows whose result changed,
+     * in ascending order.
+     */
+    Signal<const std::vector<std::size_t> &> &resultsChanged() const
+    {
+        return m_resultsChanged;
+    }
+
+    /** Reports the memory used by the columns, the results and the uniforms. */
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(BindingBatch);
+        auto addVector = [&usage](const auto &vector) {
+            using Value = typename std::decay_t<decltype(vector)>::value_type;
+            usage.liveBytes += vector.size() * sizeof(Value);
+            usage.deadBytes += (vector.capacity() - vector.size()) * sizeof(Value);
+        };
+        std::apply([&addVector](const auto &...columns) { (addVector(columns), ...); }, m_columns);
+        addVector(m_results);
+        addVector(m_scratch);
+        addVector(m_rowDirty);
+        addVector(m_dirtyRows);
+        addVector(m_changedRows);
+        std::apply([&usage](const auto &...nodes) { ((usage += nodes.memoryUsage()), ...); }, m_uniforms);
+        return usage;
+    }
+
+private:
+    void markDirty() override
+    {
+        // One of the uniforms changed.
+        m_allDirty = true;
+    }
+
+    Private::Dirtyable **parentVariable() override { return nullptr; }
+    const bool *dirtyVariable() const override { return nullptr; }
+
+    void checkRow(std::size_t row) const
+    {
+        if (row >= m_results.size()) {
+            throw std::out_of_range("The row does not exist in this BindingBatch");
+        }
+    }
+
+    void markRowDirty(std::size_t row)
+    {
+        if (!m_rowDirty[row]) {
+            m_rowDirty[row] = 1;
+            m_dirtyRows.push_back(row);
+        }
+    }
+
+    // The references point to the values cached by the nodes, which stay valid until the next evaluation.
+    std::tuple<const Us &...> evaluateUniforms() const
+    {
+        return std::apply([](const auto &...nodes) { return std::tuple<const Us &...>(nodes.evaluate()...); }, m_uniforms);
+    }
+
+    template<std::size_t... Is>
+    void appendColumns(std::index_sequence<Is...>, Cs &&...values)
+    {
+        (std::get<Is>(m_columns).push_back(std::move(values)), ...);
+    }
+
+    template<std::size_t... Is>
+    void swapRows(std::size_t a, std::size_t b, std::index_sequence<Is...>)
+    {
+        using std::swap;
+        (swap(std::get<Is>(m_columns)[a], std::get<Is>(m_columns)[b]), ...);
+        swap(m_results[a], m_results[b]);
+        swap(m_rowDirty[a], m_rowDirty[b]);
+    }
+
+    template<std::size_t... Is>
+    void evaluateAllRows(const std::tuple<const Us &...> &uniforms, std::index_sequence<Is...>)
+    {
+        const std::size_t rows = m_results.size();
+        m_scratch.resize(rows);
+
+        std::apply([&](const auto &...uniformValues) {
+            // Hoist the data pointers out of the loop, so the compiler doesn't need to reload them.
+            auto columns = std::make_tuple(std::get<Is>(m_columns).data()...);
+            ResultType *out = m_scratch.data();
+            for (std::size_t row = 0; row < rows; ++row) {
+                out[row] = m_func(std::get<Is>(columns)[row]..., uniformValues...);
+            }
+        },
+                   uniforms);
+
+        for (std::size_t row = 0; row < rows; ++row) {
+            if (!equal_to<ResultType>{}(m_scratch[row], m_results[row])) {
+                m_changedRows.push_back(row);
+            }
+        }
+        m_results.swap(m_scratch);
+    }
+
+    template<std::size_t... Is>
+    void evaluateDirtyRows(const std::tuple<const Us &...> &uniforms, std::index_sequence<Is...>)
+    {
+        std::apply([&](const auto &...uniformValues) {
+            for (const auto row : m_dirtyRows) {
+                // Rows may have been removed since they were marked as dirty.
+                if (row >= m_results.size() || !m_rowDirty[row]) {
+                    continue;
+                }
+                m_rowDirty[row] = 0;
+
+                ResultType result = m_func(std::get<Is>(m_columns)[row]..., uniformValues...);
+                if (!equal_to<ResultType>{}(result, m_results[row])) {
+                    m_results[row] = std::move(result);
+                    m_changedRows.push_back(row);
+                }
+            }
+        },
+                   uniforms);
+
+        std::sort(m_changedRows.begin(), m_changedRows.end());
+    }
+
+    Func m_func;
+    std::tuple<Private::Node<Us>...> m_uniforms;
+
+    std::tuple<std::vector<Cs>...> m_columns;
+    std::vector<ResultType> m_results;
+    // Receives the results of evaluateAllRows(), so the previous results can be compared.
+    std::vector<ResultType> m_scratch;
+
+    std::vector<std::uint8_t> m_rowDirty;
+    std::vector<std::size_t> m_dirtyRows;
+    bool m_allDirty = false;
+
+    std::vector<std::size_t> m_changedRows;
+    mutable Signal<const std::vector<std::size_t> &> m_resultsChanged;
+};
+
+/**
+ * @brief Creates a BindingBatch with the given column types.
+ *
+ * @warning BindingBatch is experimental and may be removed or changed in the future.
+ *
+ * @tparam Cs The types of the columns, which must be given explicitly.
+ * @param func The function that computes the result of a row from the values of the columns,
+ *             followed by the values of the uniforms.
+ * @param uniforms Values shared by all rows - Possible values include: Properties, Constants and Nodes.
+ *                 They will be automatically unwrapped, i.e. a Property<T> will pass a value of type T to func.
+ *
+ * @see BindingBatch
+ */
+template<typename... Cs, typename Func, typename... Us>
+inline BindingBatch<std::decay_t<Func>, std::tuple<Cs...>, std::tuple<Private::bindable_value_type_t<Us>...>>
+makeBindingBatch(Func &&func, Us &&...uniforms)
+{
+    return BindingBatch<std::decay_t<Func>, std::tuple<Cs...>, std::tuple<Private::bindable_value_type_t<Us>...>>(
+            std::forward<Func>(func), Private::makeNode(std::forward<Us>(uniforms))...);
+}
+
+} // namespace KDBindings
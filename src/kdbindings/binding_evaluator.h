@@ -15,6 +15,8 @@
 #include <map>
 #include <memory>
 
+#include <kdbindings/memory_usage.h>
+
 namespace KDBindings {
 
 /**
@@ -95,6 +97,24 @@ public:
             func();
     }
 
+    /**
+     * Reports the memory used by the collection of Bindings of this evaluator.
+     *
+     * As copies of a BindingEvaluator share the same collection, they also report
+     * the same memory usage.
+     */
+    MemoryUsage memoryUsage() const noexcept
+    {
+        // std::map allocates a tree node for every entry, which stores the entry
+        // alongside three pointers and a color flag.
+        constexpr auto nodeSize = sizeof(decltype(m_d->m_bindingEvalFunctions)::value_type) + 4 * sizeof(void *);
+
+        MemoryUsage usage;
+        usage.liveSlots = m_d->m_bindingEvalFunctions.size();
+        usage.liveBytes = sizeof(Private) + usage.liveSlots * nodeSize;
+        return usage;
+    }
+
 private:
     template<typename BindingType>
     int insert(BindingType *binding)
@@ -0,0 +1,395 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <system_error>
+#include <unistd.h>
+#endif
+
+namespace KDBindings {
+
+/**
+ * @brief ChangeFeedSerializer converts the values of Properties tracked by a ChangeFeed to bytes and back.
+ *
+ * @warning ChangeFeed is experimental and may be removed or changed in the future.
+ *
+ * Trivially copyable types are stored as their object representation, std::string as its characters.
+ * To track Properties of other types, provide a template specialization of
+ * KDBindings::ChangeFeedSerializer with the same two static functions.
+ */
+template<typename T, typename = void>
+struct ChangeFeedSerializer {
+    static_assert(std::is_trivially_copyable_v<T>, "Provide a specialization of KDBindings::ChangeFeedSerializer to track Properties of this type");
+};
+
+template<typename T>
+struct ChangeFeedSerializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+    /** Appends the bytes of the value to the buffer. */
+    static void serialize(const T &value, std::vector<std::byte> &buffer)
+    {
+        const auto offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    /**
+     * Restores a value from the bytes that serialize() produced.
+     *
+     * @throw std::length_error If the size doesn't match the size of T.
+     */
+    static T deserialize(const std::byte *data, std::size_t size)
+    {
+        if (size != sizeof(T)) {
+            throw std::length_error("The size of a change feed record doesn't match the size of its type");
+        }
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+};
+
+template<>
+struct ChangeFeedSerializer<std::string> {
+    static void serialize(const std::string &value, std::vector<std::byte> &buffer)
+    {
+        const auto *bytes = reinterpret_cast<const std::byte *>(value.data());
+        buffer.insert(buffer.end(), bytes, bytes + value.size());
+    }
+
+    static std::string deserialize(const std::byte *data, std::size_t size)
+    {
+        return std::string(reinterpret_cast<const char *>(data), size);
+    }
+};
+
+/**
+ * @brief A record of a ChangeFeed, as passed to the callback of ChangeFeed::parse().
+ *
+ * The data is only valid during the callback.
+ */
+struct ChangeRecord {
+    std::uint32_t propertyId;
+    std::uint64_t version;
+    const std::byte *data;
+    std::size_t size;
+};
+
+/**
+ * @brief A ChangeFeed collects the changes of a set of Properties into compact binary records,
+ * for example to mirror them into another process.
+ *
+ * @warning ChangeFeed is experimental and may be removed or changed in the future.
+ *
+ * Every tracked Property is identified by an id chosen by the caller, which must be the same on
+ * the consuming side.
+ * When a tracked Property changes, its new value is kept in the ChangeFeed, replacing any value
+ * that was not flushed yet. flush() then serializes the latest value of every Property that
+ * changed since the previous flush, in the order of their first change, and passes all
+ * records to the sink in a single buffer.
+ * Consumers therefore only receive one record per changed Property and flush, no matter how
+ * often it changed, and never receive the state of unchanged Properties.
+ *
+ * Each record holds the id of the Property, its version and its serialized value.
+ * The version of a Property is 0 when it is tracked and counts every change, so the difference
+ * to the previously received version tells how many changes were coalesced.
+ * The current value of a Property is flushed once after it is tracked, so a consumer that reads the
+ * feed from the start receives the full state, followed by deltas.
+ *
+ * Records are encoded as three LEB128 varints (id, version, size of the value) followed by the bytes
+ * of the value, as produced by ChangeFeedSerializer. Records are self-delimiting, so the buffers
+ * of consecutive flushes can be written to the same file or pipe, and ChangeFeed::parse() reads
+ * them back.
+ *
+ * Just like a Property, a ChangeFeed is not thread-safe: the Properties must be changed in the
+ * thread that calls flush(). A ChangeFeed can neither be copied nor moved.
+ *
+ * Example:
+ * @code
+ * std::ofstream file("model.feed", std::ios::binary);
+ * ChangeFeed feed(ChangeFeed::streamSink(file));
+ * feed.track(1, width);
+ * feed.track(2, title);
+ * ...
+ * feed.flush(); // e.g. once per frame
+ * @endcode
+ */
+class ChangeFeed
+{
+public:
+    /** Receives the encoded records of one flush. */
+    using Sink = std::function<void(const std::byte *data, std::size_t size)>;
+
+    /** Creates a ChangeFeed that passes its records to the given sink. */
+    explicit ChangeFeed(Sink sink)
+        : m_sink(std::move(sink))
+    {
+    }
+
+    /** A ChangeFeed can not be copied. */
+    ChangeFeed(const ChangeFeed &) = delete;
+    /** A ChangeFeed can not be copied. */
+    ChangeFeed &operator=(const ChangeFeed &) = delete;
+    /** A ChangeFeed can not be moved, as the connections to the tracked Properties refer to it. */
+    ChangeFeed(ChangeFeed &&) = delete;
+    /** A ChangeFeed can not be moved, as the connections to the tracked Properties refer to it. */
+    ChangeFeed &operator=(ChangeFeed &&) = delete;
+
+    /**
+     * Starts tracking the Property under the given id. Its current value is included in the next flush.
+     *
+     * The value is copied once per change. The Property may be destroyed before the ChangeFeed,
+     * its last value is still flushed if it changed.
+     *
+     * @throw std::invalid_argument If the id is already used by another Property.
+     */
+    template<typename T>
+    void track(std::uint32_t id, const Property<T> &property)
+    {
+        if (m_entries.count(id) != 0) {
+            throw std::invalid_argument("The id is already used by another Property of the ChangeFeed");
+        }
+
+        auto entry = std::make_unique<TypedEntry<T>>(id, property.get());
+        auto *entryPtr = entry.get();
+        entry->connection = property.valueChanged().connect([this, entryPtr](const T &value) {
+            entryPtr->latest = value;
+            ++entryPtr->version;
+            markPending(*entryPtr);
+        });
+        markPending(*entryPtr);
+        m_entries.emplace(id, std::move(entry));
+    }
+
+    /**
+     * Stops tracking the Property with the given id. Changes that were not flushed yet are dropped.
+     *
+     * @return Whether a Property with this id was tracked.
+     */
+    bool untrack(std::uint32_t id)
+    {
+        const auto it = m_entries.find(id);
+        if (it == m_entries.end()) {
+            return false;
+        }
+        m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), it->second.get()), m_pending.end());
+        m_entries.erase(it);
+        return true;
+    }
+
+    /** Returns the number of tracked Properties. */
+    std::size_t trackedCount() const noexcept
+    {
+        return m_entries.size();
+    }
+
+    /** Returns the number of Properties that changed since the last flush. */
+    std::size_t pendingCount() const noexcept
+    {
+        return m_pending.size();
+    }
+
+    /**
+     * Encodes a record for every Property that changed since the last flush, and passes them to the sink.
+     *
+     * The sink is not called if nothing changed.
+     * If the sink throws, the changes stay pending and are included in the next flush.
+     *
+     * @return The number of records that were flushed.
+     */
+    std::size_t flush()
+    {
+        if (m_pending.empty()) {
+            return 0;
+        }
+
+        // Both buffers keep their capacity, so flushes don't allocate once they reached their typical size.
+        m_buffer.clear();
+        for (Entry *entry : m_pending) {
+            m_value.clear();
+            entry->serialize(m_value);
+            writeVarint(entry->id);
+            writeVarint(entry->version);
+            writeVarint(m_value.size());
+            m_buffer.insert(m_buffer.end(), m_value.begin(), m_value.end());
+        }
+
+        m_sink(m_buffer.data(), m_buffer.size());
+
+        const auto count = m_pending.size();
+        for (Entry *entry : m_pending) {
+            entry->pending = false;
+        }
+        m_pending.clear();
+        return count;
+    }
+
+    /**
+     * Decodes the records in the given data and calls the callback with every complete record.
+     *
+     * A record at the end of the data that is incomplete, e.g. because only a part of it was
+     * read from a pipe yet, is not decoded.
+     *
+     * @return The number of bytes that were consumed. The remaining bytes belong to the next record.
+     * @throw std::invalid_argument If the data is not a valid change feed.
+     */
+    template<typename Callback>
+    static std::size_t parse(const std::byte *data, std::size_t size, Callback &&callback)
+    {
+        std::size_t consumed = 0;
+        while (consumed < size) {
+            std::size_t position = consumed;
+            std::uint64_t id = 0;
+            std::uint64_t version = 0;
+            std::uint64_t valueSize = 0;
+            if (!readVarint(data, size, position, id) || !readVarint(data, size, position, version) || !readVarint(data, size, position, valueSize)) {
+                break;
+            }
+            if (id > UINT32_MAX) {
+                throw std::invalid_argument("Invalid property id in change feed");
+            }
+            if (valueSize > size - position) {
+                break;
+            }
+
+            callback(ChangeRecord{ static_cast<std::uint32_t>(id), version, data + position, static_cast<std::size_t>(valueSize) });
+            consumed = position + static_cast<std::size_t>(valueSize);
+        }
+        return consumed;
+    }
+
+    /** Returns a sink that writes the records to the given stream, e.g. a std::ofstream opened in binary mode. */
+    static Sink streamSink(std::ostream &stream)
+    {
+        return [&stream](const std::byte *data, std::size_t size) {
+            stream.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+            stream.flush();
+            if (!stream) {
+                throw std::runtime_error("Failed to write the change feed to the stream");
+            }
+        };
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    /**
+     * Returns a sink that writes the records to the given file descriptor, e.g. a pipe or a socket.
+     *
+     * The sink blocks until all records are written. The file descriptor is not closed.
+     *
+     * @note Only available on Unix-like systems.
+     */
+    static Sink fileDescriptorSink(int fd)
+    {
+        return [fd](const std::byte *data, std::size_t size) {
+            while (size > 0) {
+                const ssize_t written = ::write(fd, data, size);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "Failed to write the change feed");
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+        };
+    }
+#endif
+
+private:
+    struct Entry {
+        explicit Entry(std::uint32_t entryId)
+            : id(entryId)
+        {
+        }
+        virtual ~Entry() = default;
+        virtual void serialize(std::vector<std::byte> &buffer) const = 0;
+
+        const std::uint32_t id;
+        std::uint64_t version = 0;
+        bool pending = false;
+        ScopedConnection connection;
+    };
+
+    template<typename T>
+    struct TypedEntry : Entry {
+        TypedEntry(std::uint32_t entryId, const T &value)
+            : Entry(entryId), latest(value)
+        {
+        }
+
+        void serialize(std::vector<std::byte> &buffer) const override
+        {
+            ChangeFeedSerializer<T>::serialize(latest, buffer);
+        }
+
+        T latest;
+    };
+
+    void markPending(Entry &entry)
+    {
+        if (!entry.pending) {
+            entry.pending = true;
+            m_pending.push_back(&entry);
+        }
+    }
+
+    void writeVarint(std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            m_buffer.push_back(static_cast<std::byte>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        m_buffer.push_back(static_cast<std::byte>(value));
+    }
+
+    // Returns false if the data ends before the varint does.
+    static bool readVarint(const std::byte *data, std::size_t size, std::size_t &position, std::uint64_t &value)
+    {
+        value = 0;
+        for (unsigned shift = 0; position < size; shift += 7) {
+            if (shift >= 64) {
+                throw std::invalid_argument("Invalid varint in change feed");
+            }
+            const auto byte = static_cast<std::uint8_t>(data[position++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Sink m_sink;
+    std::unordered_map<std::uint32_t, std::unique_ptr<Entry>> m_entries;
+    std::vector<Entry *> m_pending;
+    std::vector<std::byte> m_buffer;
+    std::vector<std::byte> m_value;
+};
+
+} // namespace KDBindings
@@ -0,0 +1,197 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <functional>
+#include <utility>
+
+#include <kdbindings/make_node.h>
+#include <kdbindings/memory_usage.h>
+#include <kdbindings/node.h>
+#include <kdbindings/node_functions.h>
+#include <kdbindings/node_operators.h>
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+namespace KDBindings {
+
+/**
+ * @brief A read-only value that is computed from an expression when it is read.
+ *
+ * @warning ComputedProperty is experimental and may be removed or changed in the future.
+ *
+ * A ComputedProperty is created from the same expressions as a Binding, e.g.
+ * `makeComputedProperty(a + b * 2)`.
+ * In comparison to a Property with an immediate mode Binding, which re-evaluates the expression
+ * every time one of its inputs changes, a ComputedProperty only remembers that its value is out of
+ * date when an input changes.
+ * The expression is evaluated on the next call to get(), at most once, no matter how often the
+ * inputs changed in the meantime.
+ *
+ * As long as a slot is connected to valueChanged(), the ComputedProperty can't wait for the next
+ * read and evaluates the expression as soon as an input changes, so that the slot is notified
+ * in time.
+ * valueChanged() is only emitted if the computed value actually differs from the previous value.
+ *
+ * A ComputedProperty can neither be copied nor moved, as the node tree of its expression refers
+ * back to it.
+ */
+template<typename T>
+class ComputedProperty : private Private::Dirtyable
+{
+public:
+    /** Constructs a ComputedProperty from the root Node of an expression. */
+    explicit ComputedProperty(Private::Node<T> &&rootNode)
+        : m_rootNode{ std::move(rootNode) }
+        , m_value{ m_rootNode.evaluate() }
+    {
+        m_rootNode.setParent(this);
+    }
+
+    /** Emits the destroyed() Signal. */
+    ~ComputedProperty() override
+    {
+        m_destroyed.emit();
+    }
+
+    /** A ComputedProperty cannot be copy constructed. */
+    ComputedProperty(const ComputedProperty &) = delete;
+    /** A ComputedProperty cannot be copy assigned. */
+    ComputedProperty &operator=(const ComputedProperty &) = delete;
+    /** A ComputedProperty cannot be move constructed. */
+    ComputedProperty(ComputedProperty &&) = delete;
+    /** A ComputedProperty cannot be move assigned. */
+    ComputedProperty &operator=(ComputedProperty &&) = delete;
+
+    /**
+     * Returns the current value, evaluating the expression first if any of its inputs changed.
+     *
+     * @throw PropertyDestroyedError If the expression needs to be evaluated and references a
+     * Property that no longer exists.
+     */
+    const T &get() const
+    {
+        if (m_dirty) {
+            update();
+        }
+        return m_value;
+    }
+
+    /** Returns the current value, see get(). */
+    const T &operator()() const
+    {
+        return get();
+    }
+
+    /**
+     * Returns whether any of the inputs changed since the expression was last evaluated.
+     */
+    bool isDirty() const noexcept
+    {
+        return m_dirty;
+    }
+
+    /**
+     * Returns a Signal that is emitted with the new value whenever the computed value changes.
+     *
+     * Connecting to this Signal makes the ComputedProperty evaluate its expression whenever an
+     * input changes, instead of waiting for the next call to get().
+     *
+     * If inputs changed while nothing was connected, the expression is evaluated before the
+     * Signal is returned, as the ComputedProperty only learns about further changes once its
+     * value is up to date.
+     *
+     * @throw PropertyDestroyedError If the expression needs to be evaluated and references a
+     * Property that no longer exists.
+     */
+    Signal<const T &> &valueChanged() const
+    {
+        if (m_dirty) {
+            update();
+        }
+        return m_valueChanged;
+    }
+
+    /** Returns a Signal that is emitted when the ComputedProperty is destroyed. */
+    Signal<> &destroyed() const
+    {
+        return m_destroyed;
+    }
+
+    /** Reports the memory used by this ComputedProperty and the node tree of its expression. */
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage = m_rootNode.memoryUsage();
+        usage.liveBytes += sizeof(ComputedProperty);
+        return usage;
+    }
+
+private:
+    void markDirty() override
+    {
+        m_dirty = true;
+
+        // Nobody can observe the new value until the next read, so don't compute it yet.
+        if (m_valueChanged.connectionCount() != 0) {
+            update();
+        }
+    }
+
+    Private::Dirtyable **parentVariable() override { return nullptr; }
+    const bool *dirtyVariable() const override { return nullptr; }
+
+    void update() const
+    {
+        const T &newValue = m_rootNode.evaluate();
+        m_dirty = false;
+
+        if (equal_to<T>{}(m_value, newValue)) {
+            return;
+        }
+
+        m_value = newValue;
+        m_valueChanged.emit(m_value);
+    }
+
+    Private::Node<T> m_rootNode;
+    mutable T m_value;
+    mutable bool m_dirty = false;
+    mutable Signal<const T &> m_valueChanged;
+    mutable Signal<> m_destroyed;
+};
+
+/**
+ * @brief Helper function to create a ComputedProperty from a root Node.
+ *
+ * @param rootNode Represents the expression that is evaluated by the ComputedProperty.
+ *                  Typically constructed from a unary/binary operator on a Property.
+ * @return A new ComputedProperty that evaluates the expression when it is read.
+ */
+template<typename T>
+inline ComputedProperty<T> makeComputedProperty(Private::Node<T> &&rootNode)
+{
+    return ComputedProperty<T>(std::move(rootNode));
+}
+
+/**
+ * @brief Helper function to create a ComputedProperty from a function and its arguments.
+ *
+ * @param func The function object.
+ * @param args The function arguments - Possible values include: Properties, Constants and Nodes.
+ *              They will be automatically unwrapped, i.e. a Property<T> will pass a value of type T to func.
+ * @return A new ComputedProperty that evaluates func when it is read.
+ */
+template<typename Func, typename... Args, typename = std::enable_if_t<sizeof...(Args) != 0>, typename ResultType = Private::operator_node_result_t<Func, Args...>>
+inline ComputedProperty<ResultType> makeComputedProperty(Func &&func, Args &&...args)
+{
+    return ComputedProperty<ResultType>(Private::makeNode(std::forward<Func>(func), std::forward<Args>(args)...));
+}
+
+} // namespace KDBindings
@@ -15,9 +15,14 @@
 #include <mutex>
 
 #include <kdbindings/connection_handle.h>
+#include <kdbindings/memory_usage.h>
 
 namespace KDBindings {
 
+namespace Private {
+struct SignalAccess;
+} // namespace Private
+
 /**
  * @brief Manages and evaluates deferred Signal connections.
  *
@@ -89,6 +94,33 @@ public:
         m_isEvaluating = false;
     }
 
+    /**
+     * @brief Reports the memory used by this ConnectionEvaluator.
+     *
+     * Queued slot invocations are reported as live memory, spare capacity of the
+     * queue is reported as dead memory.
+     * The queue is not shrunk after evaluation, so that it doesn't need to allocate
+     * again for the next batch of invocations.
+     *
+     * This function is thread safe.
+     *
+     * @warning While this function is marked with noexcept, it *may* terminate the program
+     * if mutex locking isn't possible.
+     */
+    MemoryUsage memoryUsage() const noexcept
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_slotInvocationMutex);
+
+        constexpr auto entrySize = sizeof(decltype(m_deferredSlotInvocations)::value_type);
+
+        MemoryUsage usage;
+        usage.liveSlots = m_deferredSlotInvocations.size();
+        usage.deadSlots = m_deferredSlotInvocations.capacity() - usage.liveSlots;
+        usage.liveBytes = sizeof(ConnectionEvaluator) + usage.liveSlots * entrySize;
+        usage.deadBytes = usage.deadSlots * entrySize;
+        return usage;
+    }
+
 protected:
     /**
      * @brief Called when a new slot invocation is added.
@@ -110,6 +142,7 @@ protected:
 private:
     template<typename...>
     friend class Signal;
+    friend struct Private::SignalAccess;
 
     void enqueueSlotInvocation(const ConnectionHandle &handle, const std::function<void()> &slotInvocation)
     {
@@ -150,7 +183,7 @@ private:
     // We need to use a recursive mutex here, as `evaluateDeferredConnections` executes arbitrary user code.
     // This may end up in a call to dequeueSlotInvocation, which locks the same mutex.
     // We'll also need to add a flag to make sure we don't actually dequeue invocations while we're evaluating them.
-    std::recursive_mutex m_slotInvocationMutex;
+    mutable std::recursive_mutex m_slotInvocationMutex;
     bool m_isEvaluating = false;
 };
 } // namespace KDBindings
@@ -20,6 +20,9 @@ namespace KDBindings {
 template<typename... Args>
 class Signal;
 
+template<typename Callable, typename... Args>
+class HomogeneousSignal;
+
 class ConnectionHandle;
 
 namespace Private {
@@ -160,6 +163,18 @@ public:
         return shared_impl && shared_impl == std::static_pointer_cast<Private::SignalImplBase>(signal.m_impl);
     }
 
+    /**
+     * Check whether this ConnectionHandle belongs to the given HomogeneousSignal.
+     *
+     * @return true if this ConnectionHandle refers to a connection within the given HomogeneousSignal
+     **/
+    template<typename Callable, typename... Args>
+    bool belongsTo(const HomogeneousSignal<Callable, Args...> &signal) const
+    {
+        auto shared_impl = m_signalImpl.lock();
+        return shared_impl && shared_impl == std::static_pointer_cast<Private::SignalImplBase>(signal.m_impl);
+    }
+
     // Define an operator== function to compare ConnectionHandle objects.
     bool operator==(const ConnectionHandle &other) const
     {
@@ -200,6 +215,8 @@ public:
 private:
     template<typename...>
     friend class Signal;
+    template<typename, typename...>
+    friend class HomogeneousSignal;
 
     std::weak_ptr<Private::SignalImplBase> m_signalImpl;
     std::optional<Private::GenerationalIndex> m_id;
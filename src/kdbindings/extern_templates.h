@@ -0,0 +1,54 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+// The value types for which the optional KDBindingsCore library provides explicit
+// instantiations of Signal and Property.
+//
+// X is called once for every type.
+#define KDBINDINGS_FOR_EACH_CORE_TYPE(X) \
+    X(bool)                              \
+    X(char)                              \
+    X(int)                               \
+    X(unsigned int)                      \
+    X(long)                              \
+    X(unsigned long)                     \
+    X(long long)                         \
+    X(unsigned long long)                \
+    X(float)                             \
+    X(double)                            \
+    X(std::string)
+
+// Declares (EXTERN = extern) or defines (EXTERN empty) the instantiations of
+// the Signal and Property classes that a Property<TYPE> needs.
+//
+// The Signal<Property<TYPE> &> used internally to track moved Properties can not be
+// instantiated explicitly, as Signal::connectDeferred requires copyable arguments.
+#define KDBINDINGS_INSTANTIATE_PROPERTY_TEMPLATES(EXTERN, TYPE)             \
+    EXTERN template class ::KDBindings::Signal<const TYPE &>;               \
+    EXTERN template class ::KDBindings::Signal<const TYPE &, const TYPE &>; \
+    EXTERN template class ::KDBindings::Property<TYPE>;
+
+#ifdef KDBINDINGS_EXTERN_TEMPLATES
+// When linking against the KDBindingsCore library, these templates are already instantiated
+// in the library, so there is no need to instantiate them in every translation unit again.
+#define KDBINDINGS_DECLARE_EXTERN_PROPERTY_TEMPLATES(TYPE) KDBINDINGS_INSTANTIATE_PROPERTY_TEMPLATES(extern, TYPE)
+
+extern template class ::KDBindings::Signal<>;
+KDBINDINGS_FOR_EACH_CORE_TYPE(KDBINDINGS_DECLARE_EXTERN_PROPERTY_TEMPLATES)
+
+#undef KDBINDINGS_DECLARE_EXTERN_PROPERTY_TEMPLATES
+#endif
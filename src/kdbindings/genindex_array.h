@@ -20,6 +20,7 @@ IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <vector>
 #include <cstdint>
@@ -29,6 +30,8 @@ IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <stdexcept>
 #include <string>
 
+#include <kdbindings/memory_usage.h>
+
 namespace KDBindings {
 
 namespace Private {
@@ -93,6 +96,22 @@ public:
                 m_entries[index.index].generation == index.generation &&
                 m_entries[index.index].isLive;
     }
+
+    // The number of indices that are currently allocated
+    std::size_t liveCount() const noexcept
+    {
+        return m_entries.size() - m_freeIndices.size();
+    }
+
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage;
+        usage.liveSlots = liveCount();
+        usage.deadSlots = m_entries.capacity() - usage.liveSlots;
+        usage.liveBytes = usage.liveSlots * sizeof(AllocatorEntry);
+        usage.deadBytes = usage.deadSlots * sizeof(AllocatorEntry) + m_freeIndices.capacity() * sizeof(uint32_t);
+        return usage;
+    }
 };
 
 // A GenerationalIndexArray stores elements in contiguous memory just like an std::vector
@@ -206,6 +225,31 @@ public:
 
         return std::nullopt;
     }
+
+    // The number of values currently stored in the array
+    std::size_t size() const noexcept
+    {
+        return m_allocator.liveCount();
+    }
+
+    // Reports the memory held by the array, excluding sizeof(*this) and any memory
+    // the stored values allocate themselves.
+    // Slots of erased values and spare vector capacity are reported as dead.
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage = m_allocator.memoryUsage();
+
+        // Values may be set at indices the allocator did not hand out, so clamp the counts.
+        const auto liveEntries = (std::min)(size(), m_entries.capacity());
+        const auto deadEntries = m_entries.capacity() - liveEntries;
+        usage.liveBytes += liveEntries * sizeof(std::optional<Entry>);
+        usage.deadBytes += deadEntries * sizeof(std::optional<Entry>);
+
+        // The allocator tracks the same slots, so only count them once.
+        usage.liveSlots = liveEntries;
+        usage.deadSlots = deadEntries;
+        return usage;
+    }
 };
 
 } // namespace Private
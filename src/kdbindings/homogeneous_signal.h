@@ -0,0 +1,408 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <kdbindings/KDBindingsConfig.h>
+#include <kdbindings/connection_handle.h>
+#include <kdbindings/genindex_array.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace KDBindings {
+
+/**
+ * @brief A Signal whose slots are all of the same callable type, stored by value in a contiguous array.
+ *
+ * @warning HomogeneousSignal is experimental and may be removed or changed in the future.
+ *
+ * A Signal stores every slot in a std::function, so emitting it calls each slot indirectly.
+ * If all slots are of the same type, e.g. instances of one functor class with different state,
+ * a HomogeneousSignal stores them by value in a std::vector<Callable> instead.
+ * Emitting it is a loop over that vector that calls Callable::operator() directly, which the
+ * compiler can inline, unroll and vectorize.
+ *
+ * Connections are managed with the same ConnectionHandle, ScopedConnection and ConnectionBlocker
+ * as the connections of a Signal.
+ * To keep the loop free of branches, blocked connections are moved behind the unblocked ones,
+ * and disconnected connections are replaced by the last one. The order in which the slots are
+ * called is therefore unspecified.
+ *
+ * Just like for a Signal, disconnecting a connection from within a slot takes effect once all
+ * slots have been called, connecting new slots from within a slot is undefined behavior and emitting
+ * the HomogeneousSignal from one of its slots throws std::runtime_error.
+ * Blocking or unblocking a connection from within a slot only takes effect with the next emission.
+ *
+ * @tparam Callable The type of all slots. It must be invocable with lvalues of Args, and move
+ * constructible and move assignable, so it can be moved within the array. Note that lambdas
+ * are not assignable before C++20, so a functor class is usually the better choice.
+ */
+template<typename Callable, typename... Args>
+class HomogeneousSignal
+{
+    static_assert(std::is_invocable_v<Callable &, Args &...>, "The Callable must be invocable with the arguments of the HomogeneousSignal");
+    static_assert(std::is_move_constructible_v<Callable> && std::is_move_assignable_v<Callable>, "The Callable must be move constructible and move assignable");
+
+    class Impl : public Private::SignalImplBase
+    {
+    public:
+        Impl() = default;
+
+        // Impls are neither copyable nor movable, as the ConnectionHandles refer to them.
+        Impl(const Impl &) = delete;
+        Impl &operator=(const Impl &) = delete;
+        Impl(Impl &&) = delete;
+        Impl &operator=(Impl &&) = delete;
+
+        Private::GenerationalIndex connect(Callable &&callable)
+        {
+            const std::size_t position = m_callables.size();
+            const auto id = m_positions.insert(std::size_t(position));
+            m_callables.push_back(std::move(callable));
+            m_ids.push_back(id);
+            m_flags.push_back(0);
+
+            // New connections are unblocked, so they belong in front of the blocked ones.
+            swapPositions(position, m_unblockedCount);
+            ++m_unblockedCount;
+            return id;
+        }
+
+        void disconnect(const ConnectionHandle &handle) noexcept override
+        {
+            if (!handle.m_id) {
+                return;
+            }
+            const std::size_t *position = m_positions.get(*handle.m_id);
+            if (!position) {
+                return;
+            }
+
+            if (m_isEmitting) {
+                // The callables must not move while they are called.
+                m_flags[*position] |= ToBeDisconnected;
+                m_changedDuringEmit = true;
+                return;
+            }
+            erase(*position);
+        }
+
+        void disconnectAll() noexcept
+        {
+            if (m_isEmitting) {
+                for (auto &flags : m_flags) {
+                    flags |= ToBeDisconnected;
+                }
+                m_changedDuringEmit = true;
+                return;
+            }
+
+            for (const auto &id : m_ids) {
+                m_positions.erase(id);
+            }
+            m_callables.clear();
+            m_ids.clear();
+            m_flags.clear();
+            m_unblockedCount = 0;
+        }
+
+        bool blockConnection(const Private::GenerationalIndex &id, bool blocked) override
+        {
+            const std::size_t *position = m_positions.get(id);
+            if (!position) {
+                throw std::out_of_range("Provided ConnectionHandle does not match any connection\nLikely the connection was deleted before!");
+            }
+
+            const std::size_t index = *position;
+            const bool wasBlocked = m_flags[index] & Blocked;
+            if (wasBlocked == blocked) {
+                return wasBlocked;
+            }
+            m_flags[index] ^= Blocked;
+
+            if (m_isEmitting) {
+                m_changedDuringEmit = true;
+            } else if (blocked) {
+                --m_unblockedCount;
+                swapPositions(index, m_unblockedCount);
+            } else {
+                swapPositions(index, m_unblockedCount);
+                ++m_unblockedCount;
+            }
+            return wasBlocked;
+        }
+
+        bool isConnectionActive(const Private::GenerationalIndex &id) const noexcept override
+        {
+            return m_positions.get(id);
+        }
+
+        bool isConnectionBlocked(const Private::GenerationalIndex &id) const override
+        {
+            const std::size_t *position = m_positions.get(id);
+            if (!position) {
+                throw std::out_of_range("Provided ConnectionHandle does not match any connection\nLikely the connection was deleted before!");
+            }
+            return m_flags[*position] & Blocked;
+        }
+
+        bool blockAll(bool blocked) noexcept
+        {
+            const bool wasBlocked = m_blocked;
+            m_blocked = blocked;
+            return wasBlocked;
+        }
+
+        bool isBlocked() const noexcept
+        {
+            return m_blocked;
+        }
+
+        std::size_t connectionCount() const noexcept
+        {
+            return m_callables.size();
+        }
+
+        void emit(Args &...args)
+        {
+            if (m_blocked) {
+                return;
+            }
+            if (m_isEmitting) {
+                throw std::runtime_error("Signal is already emitting, nested emits are not supported!");
+            }
+            m_isEmitting = true;
+
+            Callable *callables = m_callables.data();
+            const std::size_t count = m_unblockedCount;
+            for (std::size_t i = 0; i < count; ++i) {
+                callables[i](args...);
+            }
+
+            m_isEmitting = false;
+            applyChangesDuringEmit();
+        }
+
+    private:
+        enum Flags : std::uint8_t {
+            Blocked = 1,
+            ToBeDisconnected = 2,
+        };
+
+        void swapPositions(std::size_t a, std::size_t b) noexcept
+        {
+            if (a == b) {
+                return;
+            }
+            using std::swap;
+            swap(m_callables[a], m_callables[b]);
+            swap(m_ids[a], m_ids[b]);
+            swap(m_flags[a], m_flags[b]);
+            *m_positions.get(m_ids[a]) = a;
+            *m_positions.get(m_ids[b]) = b;
+        }
+
+        void erase(std::size_t position) noexcept
+        {
+            if (position < m_unblockedCount) {
+                --m_unblockedCount;
+                swapPositions(position, m_unblockedCount);
+                position = m_unblockedCount;
+            }
+            swapPositions(position, m_callables.size() - 1);
+
+            m_positions.erase(m_ids.back());
+            m_callables.pop_back();
+            m_ids.pop_back();
+            m_flags.pop_back();
+        }
+
+        void applyChangesDuringEmit() noexcept
+        {
+            if (!m_changedDuringEmit) {
+                return;
+            }
+            m_changedDuringEmit = false;
+
+            // Every position is only filled from a higher one that was already visited.
+            for (std::size_t i = m_callables.size(); i-- > 0;) {
+                if (m_flags[i] & ToBeDisconnected) {
+                    erase(i);
+                }
+            }
+
+            // Move the unblocked connections back in front of the blocked ones.
+            m_unblockedCount = 0;
+            for (std::size_t i = 0; i < m_callables.size(); ++i) {
+                if (!(m_flags[i] & Blocked)) {
+                    swapPositions(i, m_unblockedCount);
+                    ++m_unblockedCount;
+                }
+            }
+        }
+
+        // The callables, their ids and flags are stored at the same positions.
+        // The first m_unblockedCount positions hold the unblocked connections.
+        std::vector<Callable> m_callables;
+        std::vector<Private::GenerationalIndex> m_ids;
+        std::vector<std::uint8_t> m_flags;
+        std::size_t m_unblockedCount = 0;
+        // Maps the ids of the ConnectionHandles to positions.
+        Private::GenerationalIndexArray<std::size_t> m_positions;
+
+        bool m_isEmitting = false;
+        bool m_changedDuringEmit = false;
+        bool m_blocked = false;
+    };
+
+public:
+    /** HomogeneousSignals are default constructible. */
+    HomogeneousSignal() = default;
+
+    /** HomogeneousSignals cannot be copied. */
+    HomogeneousSignal(const HomogeneousSignal &) = delete;
+    /** HomogeneousSignals cannot be copied. */
+    HomogeneousSignal &operator=(const HomogeneousSignal &) = delete;
+
+    /** HomogeneousSignals can be moved. */
+    HomogeneousSignal(HomogeneousSignal &&) noexcept = default;
+    /** HomogeneousSignals can be moved. */
+    HomogeneousSignal &operator=(HomogeneousSignal &&) noexcept = default;
+
+    /** A HomogeneousSignal disconnects all slots when it is destructed. */
+    ~HomogeneousSignal() noexcept
+    {
+        disconnectAll();
+    }
+
+    /**
+     * Connects the callable to the HomogeneousSignal, storing it by value.
+     *
+     * @return An instance of ConnectionHandle, that can be used to disconnect
+     * or temporarily block the connection.
+     */
+    KDBINDINGS_WARN_UNUSED ConnectionHandle connect(Callable callable)
+    {
+        ensureImpl();
+        return ConnectionHandle{ m_impl, m_impl->connect(std::move(callable)) };
+    }
+
+    /**
+     * Disconnects a previously connected slot.
+     *
+     * @throw std::out_of_range If the ConnectionHandle does not belong to this HomogeneousSignal.
+     */
+    void disconnect(const ConnectionHandle &handle)
+    {
+        if (m_impl && handle.belongsTo(*this) && handle.m_id.has_value()) {
+            m_impl->disconnect(handle);
+        } else {
+            throw std::out_of_range("Provided ConnectionHandle does not match any connection\nLikely the connection was deleted before!");
+        }
+    }
+
+    /** Disconnects all previously connected slots. */
+    void disconnectAll() noexcept
+    {
+        if (m_impl) {
+            m_impl->disconnectAll();
+        }
+    }
+
+    /**
+     * Sets the block state of the connection.
+     *
+     * @return Whether the connection was previously blocked.
+     * @throw std::out_of_range If the ConnectionHandle does not belong to this HomogeneousSignal.
+     */
+    bool blockConnection(const ConnectionHandle &handle, bool blocked)
+    {
+        if (m_impl && handle.belongsTo(*this) && handle.m_id.has_value()) {
+            return m_impl->blockConnection(*handle.m_id, blocked);
+        }
+        throw std::out_of_range("Provided ConnectionHandle does not match any connection\nLikely the connection was deleted before!");
+    }
+
+    /**
+     * Checks whether the connection is currently blocked.
+     *
+     * @throw std::out_of_range If the ConnectionHandle does not belong to this HomogeneousSignal.
+     */
+    bool isConnectionBlocked(const ConnectionHandle &handle) const
+    {
+        if (m_impl && handle.belongsTo(*this) && handle.m_id.has_value()) {
+            return m_impl->isConnectionBlocked(*handle.m_id);
+        }
+        throw std::out_of_range("Provided ConnectionHandle does not match any connection\nLikely the connection was deleted before!");
+    }
+
+    /**
+     * Blocks or unblocks the entire HomogeneousSignal, like Signal::blockAll().
+     *
+     * @return Whether the HomogeneousSignal was previously blocked.
+     */
+    bool blockAll(bool blocked)
+    {
+        if (!m_impl) {
+            if (!blocked) {
+                return false;
+            }
+            ensureImpl();
+        }
+        return m_impl->blockAll(blocked);
+    }
+
+    /** Checks whether the entire HomogeneousSignal is currently blocked. */
+    bool isBlocked() const noexcept
+    {
+        return m_impl && m_impl->isBlocked();
+    }
+
+    /** Returns the number of connected slots, including blocked ones. */
+    std::size_t connectionCount() const noexcept
+    {
+        return m_impl ? m_impl->connectionCount() : 0;
+    }
+
+    /**
+     * Calls all unblocked slots with the given arguments.
+     *
+     * Just like for Signal::emit(), the arguments are copied once, so consider using (const)
+     * references as Args for types that are expensive to copy.
+     * The copies are passed to every slot as lvalues.
+     */
+    void emit(Args... args) const
+    {
+        if (m_impl) {
+            m_impl->emit(args...);
+        }
+    }
+
+private:
+    friend class ConnectionHandle;
+
+    void ensureImpl()
+    {
+        if (!m_impl) {
+            // Not using std::make_shared, for the same reason as Signal.
+            m_impl = std::shared_ptr<Impl>(new Impl());
+        }
+    }
+
+    // The Impl is shared with the ConnectionHandles, which only hold a weak reference to it.
+    std::shared_ptr<Impl> m_impl;
+};
+
+} // namespace KDBindings
@@ -0,0 +1,378 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace KDBindings {
+
+template<typename... Args>
+class IntrusiveSignal;
+
+/**
+ * @brief The storage of a connection to an IntrusiveSignal, embedded in the receiver.
+ *
+ * @warning Intrusive connections are experimental and may be removed or changed in the future.
+ *
+ * A SlotHook is usually a member of the receiving class. Connecting it to an IntrusiveSignal
+ * links the hook itself into the list of connections of the IntrusiveSignal, so no memory is
+ * allocated. When the SlotHook is destructed, it unlinks itself in constant time, so the
+ * IntrusiveSignal can never call a receiver that no longer exists.
+ *
+ * A SlotHook can be connected to at most one IntrusiveSignal at a time.
+ * As the IntrusiveSignal refers to its address, a SlotHook can neither be copied nor moved.
+ *
+ * @tparam Args The arguments of the IntrusiveSignal that the SlotHook can be connected to.
+ */
+template<typename... Args>
+class SlotHook
+{
+public:
+    /** A default constructed SlotHook is not connected. */
+    SlotHook() = default;
+
+    /** A SlotHook can not be copied, as the IntrusiveSignal refers to its address. */
+    SlotHook(const SlotHook &) = delete;
+    /** A SlotHook can not be copied, as the IntrusiveSignal refers to its address. */
+    SlotHook &operator=(const SlotHook &) = delete;
+    /** A SlotHook can not be moved, as the IntrusiveSignal refers to its address. */
+    SlotHook(SlotHook &&) = delete;
+    /** A SlotHook can not be moved, as the IntrusiveSignal refers to its address. */
+    SlotHook &operator=(SlotHook &&) = delete;
+
+    /** Disconnects the SlotHook from its IntrusiveSignal. */
+    ~SlotHook() noexcept
+    {
+        disconnect();
+    }
+
+    /** Returns whether the SlotHook is currently connected to an IntrusiveSignal. */
+    bool isConnected() const noexcept
+    {
+        return m_signal != nullptr;
+    }
+
+    /** Returns whether the SlotHook is currently connected to the given IntrusiveSignal. */
+    bool belongsTo(const IntrusiveSignal<Args...> &signal) const noexcept
+    {
+        return m_signal == &signal;
+    }
+
+    /**
+     * Disconnects the SlotHook from its IntrusiveSignal in constant time.
+     *
+     * Does nothing if the SlotHook is not connected.
+     */
+    void disconnect() noexcept
+    {
+        if (m_signal) {
+            m_signal->unlink(*this);
+        }
+    }
+
+    /**
+     * Sets the block state of the connection.
+     * A blocked connection will not be called when the IntrusiveSignal is emitted.
+     *
+     * @return Whether the connection was previously blocked.
+     * @throw std::out_of_range Throws if the SlotHook is not connected.
+     */
+    bool block(bool blocked)
+    {
+        if (!m_signal) {
+            throw std::out_of_range("Cannot block a non-active connection!");
+        }
+        const bool wasBlocked = m_blocked;
+        m_blocked = blocked;
+        return wasBlocked;
+    }
+
+    /**
+     * Checks whether the connection is currently blocked.
+     *
+     * @throw std::out_of_range Throws if the SlotHook is not connected.
+     */
+    bool isBlocked() const
+    {
+        if (!m_signal) {
+            throw std::out_of_range("Cannot check whether a non-active connection is blocked!");
+        }
+        return m_blocked;
+    }
+
+private:
+    friend class IntrusiveSignal<Args...>;
+
+    // Calls the slot for the receiver that the hook was connected with.
+    using Call = void (*)(void *receiver, const Args &...args);
+
+    IntrusiveSignal<Args...> *m_signal = nullptr;
+    SlotHook *m_previous = nullptr;
+    SlotHook *m_next = nullptr;
+    Call m_call = nullptr;
+    void *m_receiver = nullptr;
+    bool m_blocked = false;
+};
+
+/**
+ * @brief A Signal whose connections are stored in SlotHooks embedded in the receivers.
+ *
+ * @warning Intrusive connections are experimental and may be removed or changed in the future.
+ *
+ * Connecting a slot to a Signal stores it in a std::function inside the Signal, and the
+ * ConnectionHandle refers to the connection through a std::weak_ptr.
+ * An IntrusiveSignal instead keeps a doubly linked list of SlotHooks, which are members of the
+ * receivers. Connecting and disconnecting only relink the hook, so they never allocate, and
+ * as every SlotHook disconnects itself when it is destructed, the receivers can't dangle.
+ * The slot is given as a template argument and called through a plain function pointer.
+ *
+ * Slots are called in the order in which they were connected. Just like for a Signal,
+ * emitting the IntrusiveSignal from one of its slots throws std::runtime_error.
+ * Disconnecting or destroying any SlotHook from within a slot is supported, including the
+ * hook of the slot that is currently called. A SlotHook that is connected from within a slot
+ * is appended to the list and is called by the ongoing emission as well, so a slot must not
+ * reconnect its own hook to the emitting IntrusiveSignal unconditionally.
+ *
+ * Example:
+ * @code
+ * class Display
+ * {
+ * public:
+ *     explicit Display(IntrusiveSignal<double> &measured)
+ *     {
+ *         measured.connect<&Display::show>(m_hook, *this);
+ *     }
+ *
+ *     void show(double value);
+ *
+ * private:
+ *     SlotHook<double> m_hook;
+ * };
+ * @endcode
+ *
+ * @tparam Args The arguments of the IntrusiveSignal.
+ */
+template<typename... Args>
+class IntrusiveSignal
+{
+public:
+    /** IntrusiveSignals are default constructible. */
+    IntrusiveSignal() = default;
+
+    /** IntrusiveSignals cannot be copied. */
+    IntrusiveSignal(const IntrusiveSignal &) = delete;
+    /** IntrusiveSignals cannot be copied. */
+    IntrusiveSignal &operator=(const IntrusiveSignal &) = delete;
+
+    /**
+     * IntrusiveSignals can be moved. All SlotHooks stay connected and now belong to this instance.
+     *
+     * Moving an IntrusiveSignal takes linear time in the number of connections.
+     */
+    IntrusiveSignal(IntrusiveSignal &&other) noexcept
+    {
+        takeConnections(other);
+    }
+
+    /**
+     * IntrusiveSignals can be moved. All SlotHooks of this instance are disconnected, and the
+     * SlotHooks of the other IntrusiveSignal now belong to this instance.
+     */
+    IntrusiveSignal &operator=(IntrusiveSignal &&other) noexcept
+    {
+        if (this != &other) {
+            disconnectAll();
+            takeConnections(other);
+        }
+        return *this;
+    }
+
+    /** An IntrusiveSignal disconnects all SlotHooks when it is destructed. */
+    ~IntrusiveSignal() noexcept
+    {
+        disconnectAll();
+    }
+
+    /**
+     * Connects the hook to the IntrusiveSignal, so that emitting it calls `Slot` for the receiver.
+     *
+     * `Slot` is usually a pointer to a member function of the receiver that can be called with
+     * the arguments of the IntrusiveSignal, e.g. `&Display::show`. Any function that can be called
+     * with a reference to the receiver, followed by the arguments, can be used as well.
+     *
+     * If the hook is already connected, it is disconnected first. The new connection is unblocked.
+     * The receiver must stay alive as long as the hook is connected, which is the case if the hook
+     * is a member of the receiver.
+     *
+     * No memory is allocated.
+     */
+    template<auto Slot, typename Receiver>
+    void connect(SlotHook<Args...> &hook, Receiver &receiver) noexcept
+    {
+        static_assert(std::is_invocable_v<decltype(Slot), Receiver &, const Args &...>,
+                      "The Slot must be callable with the receiver and the arguments of the IntrusiveSignal");
+
+        hook.disconnect();
+        hook.m_call = &callSlot<Slot, Receiver>;
+        hook.m_receiver = const_cast<void *>(static_cast<const void *>(std::addressof(receiver)));
+        hook.m_blocked = false;
+        link(hook);
+    }
+
+    /**
+     * Disconnects the hook from the IntrusiveSignal.
+     *
+     * @throw std::out_of_range If the SlotHook is not connected to this IntrusiveSignal.
+     */
+    void disconnect(SlotHook<Args...> &hook)
+    {
+        if (!hook.belongsTo(*this)) {
+            throw std::out_of_range("Provided SlotHook is not connected to this IntrusiveSignal");
+        }
+        unlink(hook);
+    }
+
+    /** Disconnects all SlotHooks. */
+    void disconnectAll() noexcept
+    {
+        while (m_first) {
+            unlink(*m_first);
+        }
+    }
+
+    /**
+     * Blocks or unblocks the entire IntrusiveSignal, like Signal::blockAll().
+     *
+     * @return Whether the IntrusiveSignal was previously blocked.
+     */
+    bool blockAll(bool blocked) noexcept
+    {
+        const bool wasBlocked = m_blocked;
+        m_blocked = blocked;
+        return wasBlocked;
+    }
+
+    /** Checks whether the entire IntrusiveSignal is currently blocked. */
+    bool isBlocked() const noexcept
+    {
+        return m_blocked;
+    }
+
+    /** Returns the number of connected SlotHooks, including blocked ones. */
+    std::size_t connectionCount() const noexcept
+    {
+        return m_connectionCount;
+    }
+
+    /**
+     * Calls the slots of all unblocked SlotHooks with the given arguments,
+     * in the order in which they were connected.
+     *
+     * @throw std::runtime_error If the IntrusiveSignal is already emitting.
+     */
+    void emit(Args... args) const
+    {
+        if (m_blocked) {
+            return;
+        }
+        if (m_isEmitting) {
+            throw std::runtime_error("Signal is already emitting, nested emits are not supported!");
+        }
+        m_isEmitting = true;
+
+        // The next hook is remembered in m_nextToCall, so unlink() can advance it
+        // if that hook is disconnected by the slot.
+        for (SlotHook<Args...> *hook = m_first; hook; hook = m_nextToCall) {
+            m_nextToCall = hook->m_next;
+            if (!hook->m_blocked) {
+                hook->m_call(hook->m_receiver, args...);
+            }
+        }
+
+        m_isEmitting = false;
+    }
+
+private:
+    friend class SlotHook<Args...>;
+
+    template<auto Slot, typename Receiver>
+    static void callSlot(void *receiver, const Args &...args)
+    {
+        std::invoke(Slot, *static_cast<Receiver *>(receiver), args...);
+    }
+
+    void link(SlotHook<Args...> &hook) noexcept
+    {
+        hook.m_signal = this;
+        hook.m_previous = m_last;
+        hook.m_next = nullptr;
+        if (m_last) {
+            m_last->m_next = &hook;
+        } else {
+            m_first = &hook;
+        }
+        m_last = &hook;
+        ++m_connectionCount;
+
+        // While emitting, m_nextToCall is only null if no hook follows the one that is called.
+        if (m_isEmitting && !m_nextToCall) {
+            m_nextToCall = &hook;
+        }
+    }
+
+    void unlink(SlotHook<Args...> &hook) noexcept
+    {
+        if (m_nextToCall == &hook) {
+            m_nextToCall = hook.m_next;
+        }
+
+        if (hook.m_previous) {
+            hook.m_previous->m_next = hook.m_next;
+        } else {
+            m_first = hook.m_next;
+        }
+        if (hook.m_next) {
+            hook.m_next->m_previous = hook.m_previous;
+        } else {
+            m_last = hook.m_previous;
+        }
+        --m_connectionCount;
+
+        hook.m_signal = nullptr;
+        hook.m_previous = nullptr;
+        hook.m_next = nullptr;
+    }
+
+    void takeConnections(IntrusiveSignal &other) noexcept
+    {
+        m_first = std::exchange(other.m_first, nullptr);
+        m_last = std::exchange(other.m_last, nullptr);
+        m_connectionCount = std::exchange(other.m_connectionCount, 0);
+        m_blocked = std::exchange(other.m_blocked, false);
+        for (SlotHook<Args...> *hook = m_first; hook; hook = hook->m_next) {
+            hook->m_signal = this;
+        }
+    }
+
+    SlotHook<Args...> *m_first = nullptr;
+    SlotHook<Args...> *m_last = nullptr;
+    std::size_t m_connectionCount = 0;
+    bool m_blocked = false;
+
+    mutable bool m_isEmitting = false;
+    mutable SlotHook<Args...> *m_nextToCall = nullptr;
+};
+
+} // namespace KDBindings
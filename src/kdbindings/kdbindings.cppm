@@ -0,0 +1,149 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+// C++20 module interface unit for KDBindings.
+// Only built if KDBindings_BUILD_MODULE is enabled, see src/kdbindings/CMakeLists.txt.
+//
+// Note that macros can not be exported from a module, so KDBINDINGS_DECLARE_FUNCTION and
+// friends still require including <kdbindings/node_functions.h>.
+
+module;
+
+#include <kdbindings/bidirectional_binding.h>
+#include <kdbindings/binding.h>
+#include <kdbindings/binding_batch.h>
+#include <kdbindings/binding_evaluator.h>
+#include <kdbindings/change_feed.h>
+#include <kdbindings/computed_property.h>
+#include <kdbindings/connection_evaluator.h>
+#include <kdbindings/connection_handle.h>
+#include <kdbindings/homogeneous_signal.h>
+#include <kdbindings/intrusive_signal.h>
+#include <kdbindings/mapped_file_property.h>
+#include <kdbindings/memory_usage.h>
+#include <kdbindings/node_functions.h>
+#include <kdbindings/node_operators.h>
+#include <kdbindings/node_strings.h>
+#include <kdbindings/node_timeseries.h>
+#include <kdbindings/parallel_emission.h>
+#include <kdbindings/persistent_containers.h>
+#include <kdbindings/property.h>
+#include <kdbindings/property_group.h>
+#include <kdbindings/property_replication.h>
+#include <kdbindings/property_updater.h>
+#include <kdbindings/queued_connection.h>
+#include <kdbindings/signal.h>
+#include <kdbindings/static_connections.h>
+#include <kdbindings/thread_event_loop.h>
+#include <kdbindings/thread_pool.h>
+#include <kdbindings/timed_emission.h>
+#include <kdbindings/timer_scheduler.h>
+
+export module kdbindings;
+
+export namespace KDBindings {
+// Signals & Slots
+using KDBindings::connectDelayed;
+using KDBindings::ConnectionBlocker;
+using KDBindings::ConnectionEvaluator;
+using KDBindings::ConnectionHandle;
+using KDBindings::connectQueued;
+using KDBindings::emitAfter;
+using KDBindings::emitParallel;
+using KDBindings::emitPeriodically;
+using KDBindings::HomogeneousSignal;
+using KDBindings::IntrusiveSignal;
+using KDBindings::ScopedConnection;
+using KDBindings::Signal;
+using KDBindings::SignalBlocker;
+using KDBindings::SlotHook;
+using KDBindings::StaticConnection;
+using KDBindings::StaticConnectionTable;
+using KDBindings::ThreadEventLoop;
+using KDBindings::ThreadPool;
+using KDBindings::TimerHandle;
+using KDBindings::TimerScheduler;
+
+// Properties
+using KDBindings::ChangeFeed;
+using KDBindings::ChangeFeedSerializer;
+using KDBindings::ChangeRecord;
+using KDBindings::equal_to;
+#if defined(__linux__)
+using KDBindings::MappedBuffer;
+using KDBindings::MappedFileProperty;
+#endif
+using KDBindings::PersistentMap;
+using KDBindings::PersistentVector;
+using KDBindings::Property;
+using KDBindings::PropertyGroup;
+using KDBindings::PropertyReplication;
+using KDBindings::PropertyUpdater;
+using KDBindings::ReadOnlyProperty;
+using KDBindings::replicate;
+using KDBindings::operator<<;
+using KDBindings::operator>>;
+
+// Data binding
+using KDBindings::BidirectionalBinding;
+using KDBindings::bindBidirectional;
+using KDBindings::Binding;
+using KDBindings::BindingBatch;
+using KDBindings::BindingEvaluator;
+using KDBindings::cached;
+using KDBindings::ComputedProperty;
+using KDBindings::ImmediateBindingEvaluator;
+using KDBindings::makeBinding;
+using KDBindings::makeBindingBatch;
+using KDBindings::makeBoundProperty;
+using KDBindings::makeComputedProperty;
+using KDBindings::PropertyDestroyedError;
+using KDBindings::uncached;
+
+// Operators and functions usable in binding expressions
+using KDBindings::operator!;
+using KDBindings::operator~;
+using KDBindings::operator+;
+using KDBindings::operator-;
+using KDBindings::operator*;
+using KDBindings::operator/;
+using KDBindings::operator%;
+using KDBindings::operator<;
+using KDBindings::operator<=;
+using KDBindings::operator>;
+using KDBindings::operator>=;
+using KDBindings::operator==;
+using KDBindings::operator!=;
+using KDBindings::operator&;
+using KDBindings::operator^;
+using KDBindings::operator|;
+using KDBindings::operator&&;
+using KDBindings::operator||;
+using KDBindings::abs;
+using KDBindings::floor;
+using KDBindings::ceil;
+using KDBindings::sin;
+using KDBindings::cos;
+using KDBindings::tan;
+using KDBindings::asin;
+using KDBindings::acos;
+using KDBindings::atan;
+using KDBindings::concat;
+using KDBindings::formatString;
+using KDBindings::movingAverage;
+using KDBindings::rate;
+using KDBindings::ewma;
+using KDBindings::windowMin;
+using KDBindings::windowMax;
+
+// Diagnostics
+using KDBindings::MemoryUsage;
+using KDBindings::trackedMemoryUsage;
+} // namespace KDBindings
@@ -0,0 +1,20 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+// This translation unit is only compiled into the optional KDBindingsCore library.
+// It contains the explicit instantiations that are declared extern in extern_templates.h.
+
+#include <kdbindings/extern_templates.h>
+
+template class ::KDBindings::Signal<>;
+
+#define KDBINDINGS_DEFINE_PROPERTY_TEMPLATES(TYPE) KDBINDINGS_INSTANTIATE_PROPERTY_TEMPLATES(, TYPE)
+KDBINDINGS_FOR_EACH_CORE_TYPE(KDBINDINGS_DEFINE_PROPERTY_TEMPLATES)
+#undef KDBINDINGS_DEFINE_PROPERTY_TEMPLATES
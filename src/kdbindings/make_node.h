@@ -103,4 +103,48 @@ struct is_bindable : std::integral_constant<
 
 } // namespace Private
 
+/**
+ * @brief Drops the caches of the nested nodes of a binding expression.
+ *
+ * Every node of an expression usually caches its value, so a sub-expression is only recomputed
+ * if one of its own inputs changed.
+ * For cheap sub-expressions of values that are cheap to copy (e.g. arithmetic on numbers), the
+ * bookkeeping of these caches can cost more than recomputing the value.
+ * uncached() turns the nested operator and function nodes of such values into intermediate nodes,
+ * which recompute their value whenever the expression is evaluated.
+ * The root node of the expression keeps its cache, as do all nodes that are wrapped with cached().
+ *
+ * Example:
+ * @code
+ * auto result = makeBoundProperty(uncached((a + b) * c - d));
+ * @endcode
+ *
+ * @warning Functions in nested nodes are called on every evaluation of the expression,
+ * even if their inputs didn't change.
+ */
+template<typename T>
+inline Private::Node<T> uncached(Private::Node<T> &&node)
+{
+    node.dropIntermediateCaches();
+    return std::move(node);
+}
+
+/**
+ * @brief Marks a node of a binding expression to keep caching its value within uncached().
+ *
+ * If a sub-expression is expensive to compute, wrapping it with cached() keeps its cache, so it is
+ * only recomputed if one of its own inputs changed.
+ *
+ * Example:
+ * @code
+ * auto result = makeBoundProperty(uncached(cached(expensiveFunction(a)) + b));
+ * @endcode
+ */
+template<typename T>
+inline Private::Node<T> cached(Private::Node<T> &&node)
+{
+    node.keepCached();
+    return std::move(node);
+}
+
 } // namespace KDBindings
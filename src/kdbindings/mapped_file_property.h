@@ -0,0 +1,371 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+namespace KDBindings {
+
+namespace Private {
+
+// A read-only memory mapping of a whole file, unmapped on destruction.
+class FileMapping
+{
+public:
+    explicit FileMapping(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to open " + path);
+        }
+
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Failed to stat " + path);
+        }
+
+        m_size = static_cast<std::size_t>(status.st_size);
+        // An empty file can't be mapped, it is represented by an empty mapping instead.
+        if (m_size != 0) {
+            m_address = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        const int error = errno;
+        ::close(fd);
+
+        if (m_address == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "Failed to map " + path);
+        }
+    }
+
+    ~FileMapping()
+    {
+        if (m_address != MAP_FAILED && m_address != nullptr) {
+            ::munmap(m_address, m_size);
+        }
+    }
+
+    FileMapping(const FileMapping &) = delete;
+    FileMapping &operator=(const FileMapping &) = delete;
+
+    const std::byte *data() const noexcept
+    {
+        return m_size == 0 ? nullptr : static_cast<const std::byte *>(m_address);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+private:
+    void *m_address = nullptr;
+    std::size_t m_size = 0;
+};
+
+// An inotify instance that watches a directory for files that are written or renamed into it,
+// closed on destruction.
+class DirectoryWatch
+{
+public:
+    explicit DirectoryWatch(const std::string &directory)
+    {
+        m_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to initialize inotify");
+        }
+        if (::inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            const int error = errno;
+            ::close(m_fd);
+            throw std::system_error(error, std::generic_category(), "Failed to watch " + directory);
+        }
+    }
+
+    ~DirectoryWatch()
+    {
+        ::close(m_fd);
+    }
+
+    DirectoryWatch(const DirectoryWatch &) = delete;
+    DirectoryWatch &operator=(const DirectoryWatch &) = delete;
+
+    int fileDescriptor() const noexcept
+    {
+        return m_fd;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+} // namespace Private
+
+/**
+ * @brief A read-only view of the contents of a memory-mapped file.
+ *
+ * @warning MappedFileProperty is experimental and may be removed or changed in the future.
+ *
+ * A MappedBuffer keeps the mapping it refers to alive, so it remains valid after the
+ * MappedFileProperty it came from mapped a newer version of the file.
+ * Copying a MappedBuffer never copies the contents of the file.
+ *
+ * Two MappedBuffers are equal if they refer to the same mapping.
+ */
+class MappedBuffer
+{
+public:
+    /** Constructs an empty MappedBuffer. */
+    MappedBuffer() = default;
+
+    /** Returns a pointer to the contents of the file, or nullptr if the file is empty. */
+    const std::byte *data() const noexcept
+    {
+        return m_mapping ? m_mapping->data() : nullptr;
+    }
+
+    /** Returns the size of the file in bytes. */
+    std::size_t size() const noexcept
+    {
+        return m_mapping ? m_mapping->size() : 0;
+    }
+
+    /** Returns whether the file is empty. */
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    bool operator==(const MappedBuffer &other) const noexcept
+    {
+        return m_mapping == other.m_mapping;
+    }
+
+    bool operator!=(const MappedBuffer &other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    template<typename T>
+    friend class MappedFileProperty;
+
+    explicit MappedBuffer(std::shared_ptr<const Private::FileMapping> &&mapping)
+        : m_mapping(std::move(mapping))
+    {
+    }
+
+    std::shared_ptr<const Private::FileMapping> m_mapping;
+};
+
+/**
+ * @brief A Property whose value is read from a memory-mapped file and updated when the file changes.
+ *
+ * @warning MappedFileProperty is experimental and may be removed or changed in the future.
+ *
+ * The file is watched with inotify. Just like a TimerScheduler, a MappedFileProperty doesn't start
+ * a thread of its own. Instead, the thread that owns it calls processEvents() whenever
+ * fileDescriptor() becomes readable, e.g. from an existing poll() or epoll based event loop,
+ * or periodically.
+ * When the file was changed, it is mapped again and the new value is assigned to the Property,
+ * which emits valueChanged() as usual.
+ * property() can be used as the source of binding expressions, e.g.
+ * `makeBoundProperty(parse, file.property())`.
+ *
+ * T can either be a trivially copyable type, which is copied from the start of the file, or
+ * MappedBuffer, which provides a view of the whole file without copying it.
+ *
+ * Changes are detected when a writer closes the file, or when another file is renamed to the
+ * watched path. The latter is the recommended way to update the file, as the contents are replaced
+ * atomically, and MappedBuffers that refer to the previous contents stay valid.
+ * Truncating the file while a MappedBuffer still refers to it is undefined behavior, as
+ * accessing the truncated part of a mapping raises SIGBUS.
+ *
+ * A MappedFileProperty can neither be copied nor moved.
+ *
+ * @note MappedFileProperty is only available on Linux.
+ */
+template<typename T>
+class MappedFileProperty
+{
+    static_assert(std::is_trivially_copyable_v<T> || std::is_same_v<T, MappedBuffer>,
+                  "MappedFileProperty requires a trivially copyable type or MappedBuffer");
+
+public:
+    /**
+     * Maps the file at the given path and starts watching it.
+     *
+     * @throw std::system_error If the file can't be mapped or watched.
+     * @throw std::length_error If the file is smaller than T.
+     */
+    explicit MappedFileProperty(std::string path)
+        : m_path(std::move(path))
+        , m_fileName(fileName(m_path))
+        // Watch the directory, as a file that is replaced by renaming another file over it
+        // would no longer be watched after the first update.
+        // The watch is added before the first load(), so changes in between aren't lost.
+        , m_watch(directory(m_path))
+        , m_property(load())
+    {
+    }
+
+    /** A MappedFileProperty can not be copied. */
+    MappedFileProperty(const MappedFileProperty &) = delete;
+    /** A MappedFileProperty can not be copied. */
+    MappedFileProperty &operator=(const MappedFileProperty &) = delete;
+    /** A MappedFileProperty can not be moved, as nodes of binding expressions may refer to its Property. */
+    MappedFileProperty(MappedFileProperty &&) = delete;
+    /** A MappedFileProperty can not be moved, as nodes of binding expressions may refer to its Property. */
+    MappedFileProperty &operator=(MappedFileProperty &&) = delete;
+
+    /** Returns the Property that holds the contents of the file, e.g. for use in binding expressions. */
+    const Property<T> &property() const noexcept
+    {
+        return m_property;
+    }
+
+    /** Returns the contents of the file. */
+    const T &get() const
+    {
+        return m_property.get();
+    }
+
+    /** Returns the contents of the file. */
+    const T &operator()() const
+    {
+        return m_property.get();
+    }
+
+    /** Returns a Signal that is emitted when the contents of the file changed. */
+    Signal<const T &> &valueChanged() const
+    {
+        return m_property.valueChanged();
+    }
+
+    /** Returns the path of the file. */
+    const std::string &path() const noexcept
+    {
+        return m_path;
+    }
+
+    /**
+     * Returns the inotify file descriptor, which becomes readable when the file might have changed.
+     *
+     * Only use it to wait for changes, call processEvents() to handle them.
+     */
+    int fileDescriptor() const noexcept
+    {
+        return m_watch.fileDescriptor();
+    }
+
+    /**
+     * Handles the pending change notifications without blocking, and reloads the file if it changed.
+     *
+     * @return Whether the file was reloaded.
+     */
+    bool processEvents()
+    {
+        alignas(inotify_event) char buffer[4096];
+        bool changed = false;
+
+        while (true) {
+            const ssize_t length = ::read(m_watch.fileDescriptor(), buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                // If events were dropped, we can't know whether one of them was for this file.
+                if ((event->mask & IN_Q_OVERFLOW) || (event->len != 0 && m_fileName == event->name)) {
+                    changed = true;
+                }
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+
+        return changed && reload();
+    }
+
+    /**
+     * Maps the file again and assigns its contents to the Property.
+     *
+     * If the file can't be mapped, or is smaller than T, the value of the Property doesn't change.
+     *
+     * @return Whether the file could be mapped.
+     */
+    bool reload()
+    {
+        try {
+            m_property = load();
+        } catch (const std::system_error &) {
+            return false;
+        } catch (const std::length_error &) {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    T load() const
+    {
+        auto mapping = std::make_shared<const Private::FileMapping>(m_path);
+        if constexpr (std::is_same_v<T, MappedBuffer>) {
+            return MappedBuffer(std::move(mapping));
+        } else {
+            if (mapping->size() < sizeof(T)) {
+                throw std::length_error("The file " + m_path + " is smaller than the type it is read as");
+            }
+            // mmap() returns a page aligned address, which is suitably aligned for any T,
+            // so T can be copied from the mapping directly, even without a default constructor.
+            return *std::launder(reinterpret_cast<const T *>(mapping->data()));
+        }
+    }
+
+    static std::string fileName(const std::string &path)
+    {
+        const auto separator = path.find_last_of('/');
+        return separator == std::string::npos ? path : path.substr(separator + 1);
+    }
+
+    static std::string directory(const std::string &path)
+    {
+        const auto separator = path.find_last_of('/');
+        return separator == std::string::npos ? std::string(".") : path.substr(0, separator + 1);
+    }
+
+    std::string m_path;
+    std::string m_fileName;
+    Private::DirectoryWatch m_watch;
+    Property<T> m_property;
+};
+
+} // namespace KDBindings
+
+#endif // __linux__
@@ -0,0 +1,137 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace KDBindings {
+
+/**
+ * @brief A MemoryUsage describes how much memory a KDBindings object occupies.
+ *
+ * It is returned by the memoryUsage() functions of Signal, Property, Binding,
+ * BindingEvaluator and ConnectionEvaluator.
+ *
+ * The memory is split into bytes that hold live data (e.g. active connections)
+ * and bytes that are allocated but currently unused (e.g. slots of disconnected
+ * connections that are kept around for reuse, or spare vector capacity).
+ * A large amount of dead bytes usually indicates a container that grew during
+ * a burst of connections and never shrank again.
+ *
+ * The numbers are a best-effort estimate. The size of allocator bookkeeping
+ * and of captures that a std::function stores on the heap can not be
+ * determined portably and are not included.
+ */
+struct MemoryUsage {
+    /** The number of bytes that hold live data. */
+    std::size_t liveBytes = 0;
+    /** The number of bytes that are allocated, but currently unused. */
+    std::size_t deadBytes = 0;
+    /** The number of live slots (e.g. active connections). */
+    std::size_t liveSlots = 0;
+    /** The number of allocated slots that are currently unused. */
+    std::size_t deadSlots = 0;
+
+    /** Returns the total number of bytes, both live and dead. */
+    std::size_t totalBytes() const noexcept
+    {
+        return liveBytes + deadBytes;
+    }
+
+    /** Accumulates the usage of another object into this one. */
+    MemoryUsage &operator+=(const MemoryUsage &other) noexcept
+    {
+        liveBytes += other.liveBytes;
+        deadBytes += other.deadBytes;
+        liveSlots += other.liveSlots;
+        deadSlots += other.deadSlots;
+        return *this;
+    }
+
+    /** Returns the combined usage of two objects. */
+    friend MemoryUsage operator+(MemoryUsage lhs, const MemoryUsage &rhs) noexcept
+    {
+        lhs += rhs;
+        return lhs;
+    }
+};
+
+namespace Private {
+
+#ifdef KDBINDINGS_ENABLE_MEMORY_TRACKING
+inline std::atomic<std::size_t> &trackedMemory() noexcept
+{
+    static std::atomic<std::size_t> bytes{ 0 };
+    return bytes;
+}
+
+// A MemoryTracker reports the number of bytes an object currently owns to the
+// process-wide counter returned by KDBindings::trackedMemoryUsage().
+// The object calls update() whenever its usage may have changed, the tracker only
+// forwards the difference to the last reported value.
+//
+// This class only exists if KDBINDINGS_ENABLE_MEMORY_TRACKING is defined. Objects must only
+// declare a MemoryTracker member in that case, as even an empty member adds padding.
+class MemoryTracker
+{
+public:
+    MemoryTracker() = default;
+
+    // Every object owns its own memory, so the tracker must not be copied along with it.
+    MemoryTracker(const MemoryTracker &) = delete;
+    MemoryTracker &operator=(const MemoryTracker &) = delete;
+
+    ~MemoryTracker() noexcept
+    {
+        update(0);
+    }
+
+    void update(std::size_t bytes) noexcept
+    {
+        auto &tracked = trackedMemory();
+        if (bytes > m_bytes) {
+            tracked.fetch_add(bytes - m_bytes, std::memory_order_relaxed);
+        } else {
+            tracked.fetch_sub(m_bytes - bytes, std::memory_order_relaxed);
+        }
+        m_bytes = bytes;
+    }
+
+private:
+    std::size_t m_bytes = 0;
+};
+#endif
+
+} // namespace Private
+
+/**
+ * @brief Returns the number of bytes currently held by all Signal connections and Bindings
+ * in this process.
+ *
+ * The counter is only maintained if KDBindings is compiled with KDBINDINGS_ENABLE_MEMORY_TRACKING
+ * defined (e.g. by setting the KDBindings_ENABLE_MEMORY_TRACKING CMake option).
+ * Otherwise, this function always returns 0.
+ *
+ * Comparing the result before and after a workload is a cheap way to detect memory
+ * that is never released, e.g. signals whose connection storage does not shrink after
+ * many connections were made and disconnected again.
+ */
+inline std::size_t trackedMemoryUsage() noexcept
+{
+#ifdef KDBINDINGS_ENABLE_MEMORY_TRACKING
+    return Private::trackedMemory().load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+} // namespace KDBindings
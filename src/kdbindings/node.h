@@ -11,14 +11,18 @@
 
 #pragma once
 
+#include <kdbindings/memory_usage.h>
 #include <kdbindings/property.h>
 #include <kdbindings/signal.h>
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace KDBindings {
 
@@ -83,15 +87,45 @@ protected:
     virtual const bool *dirtyVariable() const = 0;
 };
 
+// Values of these types are cheap enough to copy that intermediate nodes of an expression
+// pass them to their parent by value instead of caching them.
+template<typename T>
+constexpr bool is_cheap_to_copy_v = std::is_trivially_copyable_v<T> && sizeof(T) <= 2 * sizeof(void *);
+
 template<typename ResultType>
 class NodeInterface : public Dirtyable
 {
 public:
+    // The type a node passes its value to its parent node with.
+    using ValueType = std::conditional_t<is_cheap_to_copy_v<ResultType>, ResultType, const ResultType &>;
+
     // Returns a reference, because we cache each evaluated value.
     // const, because it shouldn't modify the return value of the AST.
     // Requires mutable caches
     virtual const ResultType &evaluate() const = 0;
 
+    // Used by parent nodes to retrieve the value of their child nodes.
+    // Intermediate nodes override this to compute their value on the fly.
+    virtual ValueType value() const { return evaluate(); }
+
+    // Returns a replacement for this node that doesn't cache its value, or nullptr to keep this node.
+    // Only used for child nodes of an expression, see KDBindings::uncached().
+    virtual std::unique_ptr<NodeInterface<ResultType>> makeIntermediate() { return nullptr; }
+
+    // Replaces the child nodes of this (sub-)tree by intermediate nodes where possible.
+    virtual void dropIntermediateCaches() { }
+
+    // Prevents makeIntermediate() from replacing this node, see KDBindings::cached().
+    virtual void keepCached() { }
+
+    // Reports the heap memory of this node, including all of its child nodes.
+    virtual MemoryUsage memoryUsage() const noexcept = 0;
+
+    // Appends all PropertyNodes of this (sub-)tree to the given vector, in the order
+    // they appear in the expression (i.e. depth-first, left to right).
+    // Used by Binding::rebind to retarget the tree to other Properties.
+    virtual void collectPropertyNodes(std::vector<Dirtyable *> &) { }
+
 protected:
     NodeInterface() = default;
 };
@@ -120,6 +154,38 @@ public:
         return m_interface->isDirty();
     }
 
+    MemoryUsage memoryUsage() const noexcept
+    {
+        return m_interface->memoryUsage();
+    }
+
+    void collectPropertyNodes(std::vector<Dirtyable *> &nodes)
+    {
+        m_interface->collectPropertyNodes(nodes);
+    }
+
+    typename NodeInterface<ResultType>::ValueType value() const
+    {
+        return m_interface->value();
+    }
+
+    void makeIntermediate()
+    {
+        if (auto intermediate = m_interface->makeIntermediate()) {
+            m_interface = std::move(intermediate);
+        }
+    }
+
+    void dropIntermediateCaches()
+    {
+        m_interface->dropIntermediateCaches();
+    }
+
+    void keepCached()
+    {
+        m_interface->keepCached();
+    }
+
 private:
     std::unique_ptr<NodeInterface<ResultType>> m_interface;
 };
@@ -138,6 +204,13 @@ public:
         return m_value;
     }
 
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(ConstantNode);
+        return usage;
+    }
+
 protected:
     // A constant can never be dirty, so it doesn't need to
     // know its parent, as it doesn't have to notify it.
@@ -200,6 +273,29 @@ public:
         m_property = nullptr;
     }
 
+    // Makes this node refer to another Property, without changing the shape of the tree.
+    void retarget(const Property<PropertyType> &property)
+    {
+        m_valueChangedHandle.disconnect();
+        m_movedHandle.disconnect();
+        m_destroyedHandle.disconnect();
+
+        setProperty(property);
+        this->markDirty();
+    }
+
+    void collectPropertyNodes(std::vector<Dirtyable *> &nodes) override
+    {
+        nodes.push_back(this);
+    }
+
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(PropertyNode);
+        return usage;
+    }
+
 protected:
     Dirtyable **parentVariable() override { return &m_parent; }
     const bool *dirtyVariable() const override { return &m_dirty; }
@@ -224,6 +320,9 @@ private:
     mutable bool m_dirty;
 };
 
+template<typename ResultType, typename Operator, typename... Ts>
+class IntermediateOperatorNode;
+
 template<typename ResultType, typename Operator, typename... Ts>
 class OperatorNode : public NodeInterface<ResultType>
 {
@@ -268,6 +367,40 @@ public:
         return m_result;
     }
 
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(OperatorNode);
+        std::apply([&usage](const auto &...values) { ((usage += values.memoryUsage()), ...); }, m_values);
+        return usage;
+    }
+
+    void collectPropertyNodes(std::vector<Dirtyable *> &nodes) override
+    {
+        std::apply([&nodes](auto &...values) { (values.collectPropertyNodes(nodes), ...); }, m_values);
+    }
+
+    std::unique_ptr<NodeInterface<ResultType>> makeIntermediate() override
+    {
+        if constexpr (is_cheap_to_copy_v<ResultType>) {
+            if (!m_keepCached) {
+                return std::make_unique<IntermediateOperatorNode<ResultType, Operator, Ts...>>(std::move(m_op), std::move(m_values));
+            }
+        }
+        return nullptr;
+    }
+
+    void dropIntermediateCaches() override
+    {
+        std::apply([](auto &...values) { ((values.dropIntermediateCaches(), values.makeIntermediate()), ...); }, m_values);
+        setParents<0>();
+    }
+
+    void keepCached() override
+    {
+        m_keepCached = true;
+    }
+
 protected:
     Dirtyable **parentVariable() override { return &m_parent; }
     const bool *dirtyVariable() const override { return &m_dirty; }
@@ -276,7 +409,7 @@ private:
     template<std::size_t... Is>
     ResultType reevaluate_helper(std::index_sequence<Is...>) const
     {
-        return m_op(std::get<Is>(m_values).evaluate()...);
+        return m_op(std::get<Is>(m_values).value()...);
     }
 
     ResultType reevaluate() const
@@ -288,6 +421,7 @@ private:
 
     Dirtyable *m_parent;
     mutable bool m_dirty;
+    bool m_keepCached = false;
 
     Operator m_op;
     std::tuple<Node<Ts>...> m_values;
@@ -297,6 +431,64 @@ private:
     mutable ResultType m_result;
 };
 
+// An OperatorNode that is part of a larger expression.
+//
+// Only the value of the root node of an expression is read from outside, so intermediate nodes
+// don't need to keep their value up to date. Instead, they compute it on the fly, whenever their
+// parent is evaluated, and pass it by value. They don't have a dirty flag either, so dirtiness is
+// always forwarded to the parent.
+// This is only done for values that are cheap to copy, so it mostly affects arithmetic expressions,
+// where it saves the cached value and the dirty flag of every intermediate node.
+// OperatorNodes are only replaced by intermediate nodes on request, see KDBindings::uncached().
+template<typename ResultType, typename Operator, typename... Ts>
+class IntermediateOperatorNode : public NodeInterface<ResultType>
+{
+    static_assert(is_cheap_to_copy_v<ResultType>, "Only nodes of cheap types can be intermediate nodes");
+
+public:
+    IntermediateOperatorNode(Operator &&op, std::tuple<Node<Ts>...> &&values)
+        : m_parent{ nullptr }, m_values{ std::move(values) }, m_op{ std::move(op) }
+    {
+        std::apply([this](auto &...values) { (values.setParent(this), ...); }, m_values);
+    }
+
+    const ResultType &evaluate() const override
+    {
+        // Parent nodes only call value(). Any other caller gets a reference to a slot that is
+        // shared by all intermediate nodes of this type, which is valid until the next evaluate().
+        thread_local std::optional<ResultType> result;
+        result = value();
+        return *result;
+    }
+
+    ResultType value() const override
+    {
+        return std::apply([this](const auto &...values) { return ResultType(m_op(values.value()...)); }, m_values);
+    }
+
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(IntermediateOperatorNode);
+        std::apply([&usage](const auto &...values) { ((usage += values.memoryUsage()), ...); }, m_values);
+        return usage;
+    }
+
+    void collectPropertyNodes(std::vector<Dirtyable *> &nodes) override
+    {
+        std::apply([&nodes](auto &...values) { (values.collectPropertyNodes(nodes), ...); }, m_values);
+    }
+
+protected:
+    Dirtyable **parentVariable() override { return &m_parent; }
+    const bool *dirtyVariable() const override { return nullptr; }
+
+private:
+    Dirtyable *m_parent;
+    std::tuple<Node<Ts>...> m_values;
+    Operator m_op;
+};
+
 template<typename T>
 struct is_node_helper : std::false_type {
 };
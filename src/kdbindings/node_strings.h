@@ -0,0 +1,293 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <kdbindings/make_node.h>
+#include <kdbindings/node.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace KDBindings {
+
+namespace Private {
+
+template<typename T>
+struct dependent_false : std::false_type {
+};
+
+// Large enough for any integer and for the shortest representation of a double.
+using NumberBuffer = std::array<char, 32>;
+
+// Returns the text that a value contributes to a string built by a StringBuilderNode.
+// Numbers are formatted into the given buffer, all other supported types are referenced directly.
+template<typename T>
+std::string_view toStringPiece(const T &value, NumberBuffer &buffer)
+{
+    if constexpr (std::is_same_v<T, const char *> || std::is_same_v<T, char *>) {
+        return value ? std::string_view(value) : std::string_view();
+    } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+        return std::string_view(value);
+    } else if constexpr (std::is_same_v<T, char>) {
+        buffer[0] = value;
+        return std::string_view(buffer.data(), 1);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return value ? std::string_view("true") : std::string_view("false");
+    } else if constexpr (std::is_integral_v<T>) {
+        const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        return std::string_view(buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data()));
+    } else if constexpr (std::is_floating_point_v<T>) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        if constexpr (!std::is_same_v<T, long double>) {
+            const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+            return std::string_view(buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data()));
+        }
+#endif
+        const int length = std::snprintf(buffer.data(), buffer.size(), "%Lg", static_cast<long double>(value));
+        return std::string_view(buffer.data(), static_cast<std::size_t>(std::min(length, static_cast<int>(buffer.size()) - 1)));
+    } else {
+        static_assert(dependent_false<T>::value, "Only strings, characters and numbers can be used to build strings in a binding expression");
+        return {};
+    }
+}
+
+// A part of a format string: either literal text, or a reference to one of the arguments.
+struct FormatSegment {
+    static constexpr std::size_t Literal = std::numeric_limits<std::size_t>::max();
+
+    std::string literal;
+    std::size_t argument = Literal;
+};
+
+// Splits a format string into literal text and argument references.
+// "{}" refers to the next argument, "{N}" to argument N. "{{" and "}}" are escaped braces.
+inline std::vector<FormatSegment> parseFormat(std::string_view format, std::size_t argumentCount)
+{
+    std::vector<FormatSegment> segments;
+    std::string literal;
+    std::size_t nextArgument = 0;
+
+    auto flushLiteral = [&segments, &literal]() {
+        if (!literal.empty()) {
+            segments.push_back({ std::move(literal), FormatSegment::Literal });
+            literal.clear();
+        }
+    };
+
+    for (std::size_t i = 0; i < format.size(); ++i) {
+        const char c = format[i];
+        if (c == '}') {
+            if (i + 1 < format.size() && format[i + 1] == '}') {
+                literal += '}';
+                ++i;
+                continue;
+            }
+            throw std::invalid_argument("Unmatched '}' in format string");
+        }
+        if (c != '{') {
+            literal += c;
+            continue;
+        }
+        if (i + 1 < format.size() && format[i + 1] == '{') {
+            literal += '{';
+            ++i;
+            continue;
+        }
+
+        const auto close = format.find('}', i);
+        if (close == std::string_view::npos) {
+            throw std::invalid_argument("Unmatched '{' in format string");
+        }
+
+        std::size_t argument = nextArgument++;
+        const auto index = format.substr(i + 1, close - i - 1);
+        if (!index.empty()) {
+            const auto result = std::from_chars(index.data(), index.data() + index.size(), argument);
+            if (result.ec != std::errc() || result.ptr != index.data() + index.size()) {
+                throw std::invalid_argument("Invalid argument index in format string");
+            }
+        }
+        if (argument >= argumentCount) {
+            throw std::invalid_argument("Format string refers to an argument that doesn't exist");
+        }
+
+        flushLiteral();
+        segments.push_back({ std::string(), argument });
+        i = close;
+    }
+    flushLiteral();
+
+    return segments;
+}
+
+// A node that builds a std::string from its arguments in a single pass.
+//
+// Chaining operator+ on strings creates one OperatorNode per operator, each of which allocates and
+// caches an intermediate string. This node instead measures all pieces first, so the result
+// is allocated at most once. As the result buffer is reused, re-evaluations don't allocate
+// at all, unless the result grows beyond the capacity of previous results.
+//
+// Without format segments, the arguments are concatenated in order.
+template<typename... Ts>
+class StringBuilderNode : public NodeInterface<std::string>
+{
+public:
+    explicit StringBuilderNode(std::vector<FormatSegment> &&segments, Node<Ts> &&...arguments)
+        : m_parent{ nullptr }, m_dirty{ true }, m_segments{ std::move(segments) }, m_values{ std::move(arguments)... }
+    {
+        std::apply([this](auto &...values) { (values.setParent(this), ...); }, m_values);
+        rebuild();
+    }
+
+    const std::string &evaluate() const override
+    {
+        if (m_dirty) {
+            rebuild();
+        }
+        return m_result;
+    }
+
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(StringBuilderNode) + m_result.size() + m_segments.size() * sizeof(FormatSegment);
+        usage.deadBytes = m_result.capacity() - m_result.size();
+        for (const auto &segment : m_segments) {
+            usage.liveBytes += segment.literal.capacity();
+        }
+        std::apply([&usage](const auto &...values) { ((usage += values.memoryUsage()), ...); }, m_values);
+        return usage;
+    }
+
+    void collectPropertyNodes(std::vector<Dirtyable *> &nodes) override
+    {
+        std::apply([&nodes](auto &...values) { (values.collectPropertyNodes(nodes), ...); }, m_values);
+    }
+
+protected:
+    Dirtyable **parentVariable() override { return &m_parent; }
+    const bool *dirtyVariable() const override { return &m_dirty; }
+
+private:
+    template<std::size_t... Is>
+    void collectPieces(std::array<std::string_view, sizeof...(Ts)> &pieces, std::index_sequence<Is...>) const
+    {
+        ((pieces[Is] = toStringPiece(std::get<Is>(m_values).evaluate(), m_numberBuffers[Is])), ...);
+    }
+
+    void rebuild() const
+    {
+        m_dirty = false;
+
+        std::array<std::string_view, sizeof...(Ts)> pieces;
+        collectPieces(pieces, std::index_sequence_for<Ts...>());
+
+        auto pieceOf = [&pieces](const FormatSegment &segment) {
+            return segment.argument == FormatSegment::Literal ? std::string_view(segment.literal) : pieces[segment.argument];
+        };
+
+        std::size_t size = 0;
+        if (m_segments.empty()) {
+            for (const auto &piece : pieces) {
+                size += piece.size();
+            }
+        } else {
+            for (const auto &segment : m_segments) {
+                size += pieceOf(segment).size();
+            }
+        }
+
+        // clear() keeps the capacity, so this only allocates if the result grows.
+        m_result.clear();
+        m_result.reserve(size);
+        if (m_segments.empty()) {
+            for (const auto &piece : pieces) {
+                m_result.append(piece);
+            }
+        } else {
+            for (const auto &segment : m_segments) {
+                m_result.append(pieceOf(segment));
+            }
+        }
+    }
+
+    Dirtyable *m_parent;
+    mutable bool m_dirty;
+
+    std::vector<FormatSegment> m_segments;
+    std::tuple<Node<Ts>...> m_values;
+
+    mutable std::array<NumberBuffer, sizeof...(Ts)> m_numberBuffers;
+    mutable std::string m_result;
+};
+
+} // namespace Private
+
+/**
+ * @brief Creates a binding expression that concatenates its arguments into a std::string.
+ *
+ * The arguments may be Properties, Nodes or constant values of string types (std::string,
+ * std::string_view, string literals), characters or numbers.
+ * Numbers are formatted using std::to_chars, i.e. without locale and in their shortest form.
+ *
+ * In comparison to chaining operator+, e.g. `prefix + name + ": " + value`, the
+ * resulting string is built in a single pass without any intermediate strings, and its buffer is
+ * reused when the expression is re-evaluated.
+ *
+ * Example:
+ * @code
+ * auto label = makeBoundProperty(concat(prefix, name, ": ", value));
+ * @endcode
+ */
+template<typename... Ts>
+inline Private::Node<std::string> concat(Ts &&...args)
+{
+    return Private::Node<std::string>(std::make_unique<Private::StringBuilderNode<Private::bindable_value_type_t<Ts>...>>(
+            std::vector<Private::FormatSegment>(),
+            Private::makeNode(std::forward<Ts>(args))...));
+}
+
+/**
+ * @brief Creates a binding expression that formats its arguments into a std::string.
+ *
+ * The format string is parsed once, when the expression is created.
+ * "{}" is replaced by the next argument, "{N}" by the argument with index N, and "{{" and "}}"
+ * produce literal braces. Format specifications are not supported.
+ *
+ * The arguments are the same as for concat(), and the result buffer is reused in the same way.
+ *
+ * Example:
+ * @code
+ * auto label = makeBoundProperty(formatString("{}: {} of {}", name, done, total));
+ * @endcode
+ *
+ * @throw std::invalid_argument If the format string is malformed or refers to an argument that doesn't exist.
+ */
+template<typename... Ts>
+inline Private::Node<std::string> formatString(std::string_view format, Ts &&...args)
+{
+    return Private::Node<std::string>(std::make_unique<Private::StringBuilderNode<Private::bindable_value_type_t<Ts>...>>(
+            Private::parseFormat(format, sizeof...(Ts)),
+            Private::makeNode(std::forward<Ts>(args))...));
+}
+
+} // namespace KDBindings
@@ -0,0 +1,632 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <kdbindings/memory_usage.h>
+#include <kdbindings/node.h>
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+#include <kdbindings/timer_scheduler.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace KDBindings {
+
+namespace Private {
+
+using TimePoint = std::chrono::steady_clock::time_point;
+
+// A queue with a fixed capacity, that never allocates after construction.
+template<typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(std::size_t capacity)
+        : m_values(capacity)
+    {
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    std::size_t capacity() const noexcept { return m_values.size(); }
+    bool empty() const noexcept { return m_size == 0; }
+    bool full() const noexcept { return m_size == m_values.size(); }
+
+    T &front() { return m_values[m_first]; }
+    T &back() { return m_values[wrap(m_first + m_size - 1)]; }
+    const T &front() const { return m_values[m_first]; }
+    const T &back() const { return m_values[wrap(m_first + m_size - 1)]; }
+
+    // Must not be called if the buffer is full.
+    void push_back(T value)
+    {
+        m_values[wrap(m_first + m_size)] = std::move(value);
+        ++m_size;
+    }
+
+    void pop_front()
+    {
+        m_first = wrap(m_first + 1);
+        --m_size;
+    }
+
+    void pop_back()
+    {
+        --m_size;
+    }
+
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage;
+        usage.liveBytes = m_size * sizeof(T);
+        usage.deadBytes = (m_values.capacity() - m_size) * sizeof(T);
+        return usage;
+    }
+
+private:
+    std::size_t wrap(std::size_t index) const noexcept
+    {
+        return index >= m_values.size() ? index - m_values.size() : index;
+    }
+
+    std::vector<T> m_values;
+    std::size_t m_first = 0;
+    std::size_t m_size = 0;
+};
+
+template<typename T>
+struct TimedSample {
+    TimePoint time;
+    T value;
+};
+
+// The samples of a source Property that lie within a time window, which ends at the current time.
+// The most recent sample stays in the window, as it is the value the Property still holds.
+// The accumulator is notified about every sample that enters or leaves the window, so it can keep
+// its result up to date without looking at the other samples.
+template<typename T>
+class SampleWindow
+{
+public:
+    SampleWindow(TimerScheduler::Duration window, std::size_t capacity)
+        : m_window(window), m_samples(capacity)
+    {
+        if (window <= TimerScheduler::Duration::zero()) {
+            throw std::invalid_argument("The window of a time series must be positive");
+        }
+        if (capacity == 0) {
+            throw std::invalid_argument("The capacity of a time series must not be zero");
+        }
+    }
+
+    template<typename AddFunc, typename RemoveFunc>
+    void push(TimePoint time, const T &value, AddFunc &&onAdd, RemoveFunc &&onRemove)
+    {
+        // Keep the newest samples if they arrive faster than the capacity allows for.
+        if (m_samples.full()) {
+            onRemove(m_samples.front());
+            m_samples.pop_front();
+        }
+        m_samples.push_back({ time, value });
+        onAdd(m_samples.back());
+
+        expire(time, onRemove);
+    }
+
+    // Removes the samples that left the window by the given time.
+    // Returns whether any sample was removed.
+    template<typename RemoveFunc>
+    bool expire(TimePoint now, RemoveFunc &&onRemove)
+    {
+        bool removed = false;
+        while (m_samples.size() > 1 && m_samples.front().time < now - m_window) {
+            onRemove(m_samples.front());
+            m_samples.pop_front();
+            removed = true;
+        }
+        return removed;
+    }
+
+    // The first time at which the oldest sample is outside of the window, if it isn't the most recent one.
+    std::optional<TimePoint> nextExpiry() const
+    {
+        if (m_samples.size() < 2) {
+            return std::nullopt;
+        }
+        return m_samples.front().time + m_window + TimerScheduler::Duration(1);
+    }
+
+    const RingBuffer<TimedSample<T>> &samples() const noexcept
+    {
+        return m_samples;
+    }
+
+private:
+    TimerScheduler::Duration m_window;
+    RingBuffer<TimedSample<T>> m_samples;
+};
+
+template<typename T>
+class MovingAverageAccumulator
+{
+public:
+    using ResultType = double;
+
+    MovingAverageAccumulator(TimerScheduler::Duration window, std::size_t capacity)
+        : m_window(window, capacity)
+    {
+    }
+
+    void push(TimePoint time, const T &value)
+    {
+        m_window.push(
+                time, static_cast<double>(value),
+                [this](const TimedSample<double> &sample) { m_sum += sample.value; },
+                [this](const TimedSample<double> &sample) { m_sum -= sample.value; });
+    }
+
+    bool expire(TimePoint now)
+    {
+        return m_window.expire(now, [this](const TimedSample<double> &sample) { m_sum -= sample.value; });
+    }
+
+    std::optional<TimePoint> nextExpiry() const
+    {
+        return m_window.nextExpiry();
+    }
+
+    double result() const
+    {
+        const auto &samples = m_window.samples();
+        return samples.empty() ? 0.0 : m_sum / static_cast<double>(samples.size());
+    }
+
+    MemoryUsage memoryUsage() const noexcept { return m_window.samples().memoryUsage(); }
+
+private:
+    SampleWindow<double> m_window;
+    double m_sum = 0.0;
+};
+
+template<typename T>
+class RateAccumulator
+{
+public:
+    using ResultType = double;
+
+    RateAccumulator(TimerScheduler::Duration window, std::size_t capacity)
+        : m_window(window, capacity)
+    {
+    }
+
+    void push(TimePoint time, const T &value)
+    {
+        m_window.push(
+                time, static_cast<double>(value), [](const TimedSample<double> &) {}, [](const TimedSample<double> &) {});
+    }
+
+    bool expire(TimePoint now)
+    {
+        return m_window.expire(now, [](const TimedSample<double> &) {});
+    }
+
+    std::optional<TimePoint> nextExpiry() const
+    {
+        return m_window.nextExpiry();
+    }
+
+    double result() const
+    {
+        const auto &samples = m_window.samples();
+        if (samples.size() < 2) {
+            return 0.0;
+        }
+        const std::chrono::duration<double> elapsed = samples.back().time - samples.front().time;
+        if (elapsed.count() <= 0.0) {
+            return 0.0;
+        }
+        return (samples.back().value - samples.front().value) / elapsed.count();
+    }
+
+    MemoryUsage memoryUsage() const noexcept { return m_window.samples().memoryUsage(); }
+
+private:
+    SampleWindow<double> m_window;
+};
+
+// Keeps a queue of the samples that may still become the extremum of the window, i.e. that are
+// not preceded by a more extreme sample. Every sample is added and removed at most once, so
+// updates take amortized constant time.
+template<typename T, typename Compare>
+class ExtremumAccumulator
+{
+public:
+    using ResultType = T;
+
+    ExtremumAccumulator(TimerScheduler::Duration window, std::size_t capacity)
+        : m_window(window, capacity), m_candidates(capacity)
+    {
+    }
+
+    void push(TimePoint time, const T &value)
+    {
+        m_window.push(
+                time, value,
+                [this](const TimedSample<T> &sample) {
+                    while (!m_candidates.empty() && !Compare{}(m_candidates.back().value, sample.value)) {
+                        m_candidates.pop_back();
+                    }
+                    m_candidates.push_back({ m_nextSequence++, sample.value });
+                },
+                [this](const TimedSample<T> &sample) { removeOldest(sample); });
+    }
+
+    bool expire(TimePoint now)
+    {
+        return m_window.expire(now, [this](const TimedSample<T> &sample) { removeOldest(sample); });
+    }
+
+    std::optional<TimePoint> nextExpiry() const
+    {
+        return m_window.nextExpiry();
+    }
+
+    const T &result() const
+    {
+        return m_candidates.front().value;
+    }
+
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage = m_window.samples().memoryUsage();
+        usage += m_candidates.memoryUsage();
+        return usage;
+    }
+
+private:
+    struct Candidate {
+        std::size_t sequence;
+        T value;
+    };
+
+    // The removed sample is always the oldest one.
+    void removeOldest(const TimedSample<T> &)
+    {
+        if (m_candidates.front().sequence == m_firstSequence) {
+            m_candidates.pop_front();
+        }
+        ++m_firstSequence;
+    }
+
+    SampleWindow<T> m_window;
+    RingBuffer<Candidate> m_candidates;
+    std::size_t m_firstSequence = 0;
+    std::size_t m_nextSequence = 0;
+};
+
+// The average decays towards the value the Property holds, with the time constant.
+// Updating it to a later time is therefore exact, no matter how often that happens.
+template<typename T>
+class EwmaAccumulator
+{
+public:
+    using ResultType = double;
+
+    explicit EwmaAccumulator(TimerScheduler::Duration timeConstant)
+        : m_timeConstant(timeConstant)
+    {
+        if (timeConstant <= TimerScheduler::Duration::zero()) {
+            throw std::invalid_argument("The time constant of an exponentially weighted moving average must be positive");
+        }
+    }
+
+    void push(TimePoint time, const T &value)
+    {
+        const double sample = static_cast<double>(value);
+        if (!m_hasValue) {
+            m_average = sample;
+            m_hasValue = true;
+            m_lastTime = time;
+        } else {
+            // The previous value was held until now, so it is weighted before the new value takes over.
+            advance(time);
+        }
+        m_held = sample;
+        m_heldSince = time;
+    }
+
+    bool expire(TimePoint now)
+    {
+        const double previous = m_average;
+        advance(now);
+        return m_average != previous;
+    }
+
+    // While the average hasn't reached the held value, it is brought up to date once per time constant.
+    std::optional<TimePoint> nextExpiry() const
+    {
+        if (m_average == m_held) {
+            return std::nullopt;
+        }
+        return m_lastTime + std::chrono::duration_cast<TimerScheduler::Duration>(m_timeConstant);
+    }
+
+    double result() const
+    {
+        return m_average;
+    }
+
+    MemoryUsage memoryUsage() const noexcept { return {}; }
+
+private:
+    // After this many time constants, the weight of the previous average is below the precision of a double.
+    static constexpr double s_settledTimeConstants = 40.0;
+
+    void advance(TimePoint time)
+    {
+        if (time <= m_lastTime) {
+            return;
+        }
+        if ((time - m_heldSince) / m_timeConstant >= s_settledTimeConstants) {
+            m_average = m_held;
+        } else {
+            const double elapsed = std::chrono::duration<double>(time - m_lastTime) / m_timeConstant;
+            m_average = m_held + (m_average - m_held) * std::exp(-elapsed);
+        }
+        m_lastTime = time;
+    }
+
+    std::chrono::duration<double> m_timeConstant;
+    TimePoint m_lastTime;
+    TimePoint m_heldSince;
+    double m_average = 0.0;
+    double m_held = 0.0;
+    bool m_hasValue = false;
+};
+
+// A node that aggregates the history of a Property.
+//
+// Every change of the Property is recorded with the time it happened at, and the accumulator
+// updates its result incrementally. Evaluating the node therefore only reads the result.
+// As the result also changes when samples leave the window, the node schedules a timer for the
+// next time this happens, and marks itself dirty when it fires.
+template<typename T, typename Accumulator>
+class TimeSeriesNode : public NodeInterface<typename Accumulator::ResultType>
+{
+public:
+    using ResultType = typename Accumulator::ResultType;
+
+    TimeSeriesNode(const Property<T> &property, Accumulator &&accumulator, const std::shared_ptr<TimerScheduler> &scheduler)
+        : m_parent(nullptr), m_dirty(false), m_accumulator(std::move(accumulator)), m_scheduler(scheduler)
+    {
+        if (!m_scheduler) {
+            throw std::invalid_argument("A time series requires a TimerScheduler");
+        }
+        m_accumulator.push(m_scheduler->now(), property.get());
+        m_result = m_accumulator.result();
+        scheduleExpiry();
+
+        // The Signal moves along with the Property, so the connection survives moving the Property.
+        // If the Property is destroyed, the node keeps the history recorded so far.
+        m_valueChangedHandle = property.valueChanged().connect([this](const T &value) {
+            m_accumulator.push(m_scheduler->now(), value);
+            this->markDirty();
+            scheduleExpiry();
+        });
+    }
+
+    // TimeSeriesNodes can neither be copied nor moved, as their connection and timer refer to them.
+    TimeSeriesNode(const TimeSeriesNode &) = delete;
+    TimeSeriesNode(TimeSeriesNode &&) = delete;
+
+    ~TimeSeriesNode() override
+    {
+        m_valueChangedHandle.disconnect();
+        m_expiryTimer.cancel();
+    }
+
+    const ResultType &evaluate() const override
+    {
+        if (m_dirty) {
+            m_dirty = false;
+            m_result = m_accumulator.result();
+        }
+        return m_result;
+    }
+
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage = m_accumulator.memoryUsage();
+        usage.liveBytes += sizeof(TimeSeriesNode);
+        return usage;
+    }
+
+protected:
+    Dirtyable **parentVariable() override { return &m_parent; }
+    const bool *dirtyVariable() const override { return &m_dirty; }
+
+private:
+    // Samples only get older, so a pending timer never fires too late. If it fires early,
+    // because the sample it was scheduled for was dropped already, it is simply scheduled again.
+    void scheduleExpiry()
+    {
+        if (m_expiryScheduled) {
+            return;
+        }
+        if (auto expiry = m_accumulator.nextExpiry()) {
+            const auto delay = std::chrono::duration_cast<TimerScheduler::Duration>(*expiry - m_scheduler->now());
+            m_expiryTimer = m_scheduler->schedule(delay, [this]() { expire(); });
+            m_expiryScheduled = true;
+        }
+    }
+
+    void expire()
+    {
+        m_expiryScheduled = false;
+        if (m_accumulator.expire(m_scheduler->now())) {
+            this->markDirty();
+        }
+        scheduleExpiry();
+    }
+
+    Dirtyable *m_parent;
+    mutable bool m_dirty;
+    bool m_expiryScheduled = false;
+
+    Accumulator m_accumulator;
+    std::shared_ptr<TimerScheduler> m_scheduler;
+    TimerHandle m_expiryTimer;
+    mutable ResultType m_result;
+    ConnectionHandle m_valueChangedHandle;
+};
+
+template<typename T, typename Accumulator>
+Node<typename Accumulator::ResultType> makeTimeSeriesNode(const Property<T> &property, Accumulator &&accumulator, const std::shared_ptr<TimerScheduler> &scheduler)
+{
+    return Node<typename Accumulator::ResultType>(std::make_unique<TimeSeriesNode<T, Accumulator>>(property, std::move(accumulator), scheduler));
+}
+
+} // namespace Private
+
+/**
+ * @brief Creates a binding expression that averages the values a Property had within a time window.
+ *
+ * @warning Time series nodes are experimental and may be removed or changed in the future.
+ *
+ * Every change of the Property is recorded as a sample, together with the time of the change,
+ * as reported by the clock of the TimerScheduler.
+ * The window ends at the current time. Whenever the oldest sample leaves the window, a timer of
+ * the TimerScheduler updates the result, so the average also changes when the Property doesn't.
+ * The most recent sample always stays in the window, as the Property still holds its value.
+ * The average is the arithmetic mean of all samples in the window, independent of how long each
+ * value was held.
+ *
+ * The samples are stored in a ring buffer that is allocated once, when the expression is created.
+ * Every expression records its own samples, even if several expressions refer to the same Property.
+ * If more than `capacity` samples fall within the window, the oldest samples are dropped early.
+ * Every change of the Property updates the average in constant time, regardless of the size of the window.
+ *
+ * The timers are invoked by TimerScheduler::processTimers(), which must be called in the thread
+ * that changes the Property.
+ *
+ * Example:
+ * @code
+ * auto averageLatency = makeBoundProperty(movingAverage(latency, std::chrono::seconds(5), scheduler));
+ * @endcode
+ *
+ * @param property The Property to record. It must hold an arithmetic type.
+ * @param window The duration of the window.
+ * @param scheduler The TimerScheduler that provides the clock and removes old samples from the window.
+ * It is kept alive by the expression.
+ * @param capacity The maximum number of samples within the window.
+ *
+ * @throw std::invalid_argument If the window isn't positive, the capacity is zero or the scheduler is null.
+ */
+template<typename T>
+Private::Node<double> movingAverage(const Property<T> &property, TimerScheduler::Duration window,
+                                    const std::shared_ptr<TimerScheduler> &scheduler, std::size_t capacity = 1024)
+{
+    static_assert(std::is_arithmetic_v<T>, "movingAverage requires a Property of an arithmetic type");
+    return Private::makeTimeSeriesNode(property, Private::MovingAverageAccumulator<T>(window, capacity), scheduler);
+}
+
+/**
+ * @brief Creates a binding expression that computes how fast the value of a Property changed within a time window.
+ *
+ * @warning Time series nodes are experimental and may be removed or changed in the future.
+ *
+ * The rate is the difference between the newest and the oldest sample in the window, divided by
+ * the time between them in seconds. This is typically used with counters, e.g. to turn a number
+ * of received messages into messages per second. While the window contains less than two samples
+ * with distinct timestamps, e.g. once the Property didn't change for the whole window, the rate is 0.
+ *
+ * Samples are recorded and leave the window in the same way as for movingAverage().
+ *
+ * @throw std::invalid_argument If the window isn't positive, the capacity is zero or the scheduler is null.
+ */
+template<typename T>
+Private::Node<double> rate(const Property<T> &property, TimerScheduler::Duration window,
+                           const std::shared_ptr<TimerScheduler> &scheduler, std::size_t capacity = 1024)
+{
+    static_assert(std::is_arithmetic_v<T>, "rate requires a Property of an arithmetic type");
+    return Private::makeTimeSeriesNode(property, Private::RateAccumulator<T>(window, capacity), scheduler);
+}
+
+/**
+ * @brief Creates a binding expression that computes the smallest value a Property had within a time window.
+ *
+ * @warning Time series nodes are experimental and may be removed or changed in the future.
+ *
+ * Samples are recorded and leave the window in the same way as for movingAverage(), so the window
+ * holds at least the current value of the Property. Values are compared with operator<.
+ * Updates take amortized constant time, regardless of the size of the window.
+ *
+ * @throw std::invalid_argument If the window isn't positive, the capacity is zero or the scheduler is null.
+ */
+template<typename T>
+Private::Node<T> windowMin(const Property<T> &property, TimerScheduler::Duration window,
+                           const std::shared_ptr<TimerScheduler> &scheduler, std::size_t capacity = 1024)
+{
+    return Private::makeTimeSeriesNode(property, Private::ExtremumAccumulator<T, std::less<T>>(window, capacity), scheduler);
+}
+
+/**
+ * @brief Creates a binding expression that computes the largest value a Property had within a time window.
+ *
+ * @warning Time series nodes are experimental and may be removed or changed in the future.
+ *
+ * See windowMin().
+ *
+ * @throw std::invalid_argument If the window isn't positive, the capacity is zero or the scheduler is null.
+ */
+template<typename T>
+Private::Node<T> windowMax(const Property<T> &property, TimerScheduler::Duration window,
+                           const std::shared_ptr<TimerScheduler> &scheduler, std::size_t capacity = 1024)
+{
+    return Private::makeTimeSeriesNode(property, Private::ExtremumAccumulator<T, std::greater<T>>(window, capacity), scheduler);
+}
+
+/**
+ * @brief Creates a binding expression that computes an exponentially weighted moving average of a Property.
+ *
+ * @warning Time series nodes are experimental and may be removed or changed in the future.
+ *
+ * Unlike movingAverage(), the weight of each value depends on how long the Property held it:
+ * while the Property holds a value for the time dt, the average moves towards that value by the
+ * factor 1 - exp(-dt / timeConstant). A value that is replaced without any time passing has no weight.
+ *
+ * The average is brought up to date whenever the Property changes. While it doesn't, a timer of
+ * the TimerScheduler updates the average once per time constant, until it reached the held value.
+ * No samples are stored, so each update takes constant time and no memory.
+ *
+ * @param property The Property to average. It must hold an arithmetic type.
+ * @param timeConstant The time after which the weight of a value has decayed to 1/e.
+ * @param scheduler The TimerScheduler that provides the clock and updates the average while
+ * the Property doesn't change. It is kept alive by the expression.
+ *
+ * @throw std::invalid_argument If the time constant isn't positive or the scheduler is null.
+ */
+template<typename T>
+Private::Node<double> ewma(const Property<T> &property, TimerScheduler::Duration timeConstant, const std::shared_ptr<TimerScheduler> &scheduler)
+{
+    static_assert(std::is_arithmetic_v<T>, "ewma requires a Property of an arithmetic type");
+    return Private::makeTimeSeriesNode(property, Private::EwmaAccumulator<T>(timeConstant), scheduler);
+}
+
+} // namespace KDBindings
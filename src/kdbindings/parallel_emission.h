@@ -0,0 +1,67 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include <kdbindings/signal.h>
+#include <kdbindings/thread_pool.h>
+#include <kdbindings/utils.h>
+
+namespace KDBindings {
+
+/**
+ * @brief Emits the Signal, calling the slots concurrently on the threads of the given ThreadPool.
+ *
+ * @warning Parallel emission is experimental and may be removed or changed in the future.
+ *
+ * This is meant for Signals with many independent slots that each do a considerable amount of work.
+ * The connected slots are split into chunks, which are claimed one after another by the calling
+ * thread and the workers of the pool, until all slots were called.
+ * The function returns once all slots returned.
+ *
+ * The arguments are stored once and passed to all slots from there, so the same rules as
+ * for Signal::emit() apply regarding copies.
+ * All slots must therefore be safe to call concurrently with each other.
+ *
+ * Connections that are blocked when emitParallel() is called are skipped.
+ * As with Signal::emit(), slots may disconnect connections (including their own), which takes
+ * effect once all slots have been called, and slots may block or unblock connections.
+ * Because the slots run concurrently, changes to the blocked state during the emission
+ * only take effect for the next emission.
+ *
+ * If slots throw, the remaining slots are still called, and the first exception is
+ * rethrown afterwards.
+ *
+ * ⚠️ *Note: Connecting new slots, calling disconnectAll() or emitting the same Signal
+ * from a slot is undefined behavior, just like for Signal::emit().*
+ */
+template<typename... Args>
+void emitParallel(const Signal<Args...> &signal, ThreadPool &pool, Private::non_deduced_t<Args>... args)
+{
+    Private::SignalAccess::emitConcurrently(
+            signal,
+            [&pool](std::size_t slotCount, const auto &callSlots) {
+                // Use a few chunks per thread, so that threads which are done early can take over the
+                // remaining chunks of threads that run slower slots.
+                const std::size_t chunksPerThread = 4;
+                const std::size_t maxChunks = (pool.threadCount() + 1) * chunksPerThread;
+                const std::size_t chunkSize = (std::max)(std::size_t(1), (slotCount + maxChunks - 1) / maxChunks);
+                const std::size_t chunkCount = (slotCount + chunkSize - 1) / chunkSize;
+
+                pool.parallelFor(chunkCount, [&](std::size_t chunk) {
+                    callSlots(chunk * chunkSize, (std::min)(slotCount, (chunk + 1) * chunkSize));
+                });
+            },
+            args...);
+}
+
+} // namespace KDBindings
@@ -0,0 +1,948 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <kdbindings/property.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace KDBindings {
+
+namespace Private {
+
+inline unsigned popCount(std::uint32_t bits) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcount(bits));
+#else
+    unsigned count = 0;
+    for (; bits != 0; bits &= bits - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+} // namespace Private
+
+/**
+ * @brief An immutable vector that shares its structure with the vectors it was derived from.
+ *
+ * @warning The persistent containers are experimental and may be removed or changed in the future.
+ *
+ * The elements are stored in the leaves of a tree with a branching factor of 32, and the last
+ * up to 32 elements in a separate tail.
+ * Modifying functions like set() and push_back() don't change the vector, but return a new one,
+ * which only copies the path from the root to the modified leaf, and shares everything else with
+ * the original. They therefore take O(log32 n) time, which is effectively constant.
+ * Copying a PersistentVector is O(1), as it only copies two pointers.
+ *
+ * This makes it well suited as the value of a Property<T>: snapshots of the value and the old value
+ * that is passed to Property::valueAboutToChange() don't copy any elements, and comparing a new value
+ * with the previous one skips all shared subtrees, so it takes time proportional to the modified
+ * part of the vector.
+ * If set() would not change the value of an element, the vector itself is returned, so assigning
+ * the result to a Property doesn't emit any Signals.
+ *
+ * The nodes are reference counted and never modified, so different threads may use vectors that
+ * share structure, as long as each PersistentVector instance is only used by one thread at a time.
+ */
+template<typename T>
+class PersistentVector
+{
+    static constexpr unsigned Bits = 5;
+    static constexpr std::size_t Width = std::size_t(1) << Bits;
+    static constexpr std::size_t Mask = Width - 1;
+
+    // Branch nodes only use children, leaves only use values.
+    struct Node {
+        std::vector<std::shared_ptr<const Node>> children;
+        std::vector<T> values;
+    };
+    using NodePtr = std::shared_ptr<const Node>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_reference = const T &;
+
+    /** A forward iterator over the elements of a PersistentVector. */
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            return m_leaf[m_index & Mask];
+        }
+
+        pointer operator->() const
+        {
+            return &m_leaf[m_index & Mask];
+        }
+
+        const_iterator &operator++()
+        {
+            ++m_index;
+            if ((m_index & Mask) == 0 && m_index < m_vector->size()) {
+                m_leaf = m_vector->leafFor(m_index);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const noexcept
+        {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const const_iterator &other) const noexcept
+        {
+            return m_index != other.m_index;
+        }
+
+    private:
+        friend class PersistentVector;
+
+        const_iterator(const PersistentVector *vector, std::size_t index)
+            : m_vector(vector), m_index(index), m_leaf(index < vector->size() ? vector->leafFor(index) : nullptr)
+        {
+        }
+
+        const PersistentVector *m_vector = nullptr;
+        std::size_t m_index = 0;
+        const T *m_leaf = nullptr;
+    };
+
+    /** Constructs an empty PersistentVector. */
+    PersistentVector() = default;
+
+    /** Constructs a PersistentVector with the given elements. */
+    PersistentVector(std::initializer_list<T> values)
+        : PersistentVector(values.begin(), values.end())
+    {
+    }
+
+    /** Constructs a PersistentVector with the elements of the range [first, last). */
+    template<typename InputIt>
+    PersistentVector(InputIt first, InputIt last)
+    {
+        // Nothing is shared yet, so the tail can be filled in place.
+        std::vector<T> tail;
+        tail.reserve(Width);
+        for (; first != last; ++first) {
+            if (tail.size() == Width) {
+                auto leaf = std::make_shared<Node>();
+                leaf->values = std::move(tail);
+                pushTailIntoTree(std::move(leaf));
+                tail.clear();
+                tail.reserve(Width);
+            }
+            tail.push_back(*first);
+            ++m_size;
+        }
+        if (!tail.empty()) {
+            auto leaf = std::make_shared<Node>();
+            leaf->values = std::move(tail);
+            m_tail = std::move(leaf);
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /** Returns the element at the given index, which must be less than size(). */
+    const T &operator[](std::size_t index) const
+    {
+        return leafFor(index)[index & Mask];
+    }
+
+    /**
+     * Returns the element at the given index.
+     *
+     * @throw std::out_of_range If the index is not less than size().
+     */
+    const T &at(std::size_t index) const
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("PersistentVector index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const T &front() const
+    {
+        return (*this)[0];
+    }
+
+    const T &back() const
+    {
+        return (*this)[m_size - 1];
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, m_size);
+    }
+
+    /**
+     * Returns a vector in which the element at the given index is replaced by the given value.
+     *
+     * If the element is already equal_to the value, this vector is returned.
+     *
+     * @throw std::out_of_range If the index is not less than size().
+     */
+    PersistentVector set(std::size_t index, T value) const
+    {
+        if (equal_to<T>{}(at(index), value)) {
+            return *this;
+        }
+
+        PersistentVector result(*this);
+        if (index >= tailOffset()) {
+            auto tail = std::make_shared<Node>(*m_tail);
+            tail->values[index & Mask] = std::move(value);
+            result.m_tail = std::move(tail);
+        } else {
+            result.m_root = assign(m_shift, m_root, index, std::move(value));
+        }
+        return result;
+    }
+
+    /** Returns a vector with the given value appended. */
+    PersistentVector push_back(T value) const
+    {
+        PersistentVector result(*this);
+        auto tail = std::make_shared<Node>();
+        if (m_size - tailOffset() < Width) {
+            tail->values.reserve(m_size - tailOffset() + 1);
+            if (m_tail) {
+                tail->values = m_tail->values;
+            }
+        } else {
+            result.pushTailIntoTree(m_tail);
+        }
+        tail->values.push_back(std::move(value));
+        result.m_tail = std::move(tail);
+        ++result.m_size;
+        return result;
+    }
+
+    /**
+     * Returns a vector without the last element.
+     *
+     * @throw std::out_of_range If the vector is empty.
+     */
+    PersistentVector pop_back() const
+    {
+        if (m_size == 0) {
+            throw std::out_of_range("pop_back() called on an empty PersistentVector");
+        }
+        if (m_size == 1) {
+            return PersistentVector();
+        }
+
+        PersistentVector result(*this);
+        --result.m_size;
+        if (m_size - tailOffset() > 1) {
+            auto tail = std::make_shared<Node>(*m_tail);
+            tail->values.pop_back();
+            result.m_tail = std::move(tail);
+            return result;
+        }
+
+        // The tail becomes empty, so the last leaf of the tree becomes the new tail.
+        result.m_tail = leafNodeFor(m_size - 2);
+        NodePtr root = popTail(m_shift, m_root);
+        if (m_shift > Bits && root && root->children.size() == 1) {
+            root = root->children.front();
+            result.m_shift -= Bits;
+        }
+        result.m_root = std::move(root);
+        return result;
+    }
+
+    /**
+     * Compares the elements of both vectors.
+     *
+     * Subtrees that are shared by both vectors are not compared element by element, so comparing a
+     * vector with one derived from it takes time proportional to the number of modified leaves.
+     */
+    template<typename U = T>
+    auto operator==(const PersistentVector &other) const
+            -> std::enable_if_t<Private::are_equality_comparable_v<U, U>, bool>
+    {
+        return m_size == other.m_size && nodesEqual(m_root, other.m_root, m_shift) && nodesEqual(m_tail, other.m_tail, 0);
+    }
+
+    template<typename U = T>
+    auto operator!=(const PersistentVector &other) const
+            -> std::enable_if_t<Private::are_equality_comparable_v<U, U>, bool>
+    {
+        return !(*this == other);
+    }
+
+private:
+    std::size_t tailOffset() const noexcept
+    {
+        return m_size < Width ? 0 : ((m_size - 1) >> Bits) << Bits;
+    }
+
+    const NodePtr &leafNodeFor(std::size_t index) const
+    {
+        if (index >= tailOffset()) {
+            return m_tail;
+        }
+        const NodePtr *node = &m_root;
+        for (unsigned level = m_shift; level > 0; level -= Bits) {
+            node = &(*node)->children[(index >> level) & Mask];
+        }
+        return *node;
+    }
+
+    const T *leafFor(std::size_t index) const
+    {
+        return leafNodeFor(index)->values.data();
+    }
+
+    static NodePtr newPath(unsigned level, NodePtr node)
+    {
+        if (level == 0) {
+            return node;
+        }
+        auto branch = std::make_shared<Node>();
+        branch->children.push_back(newPath(level - Bits, std::move(node)));
+        return branch;
+    }
+
+    // Moves a full tail into the tree. m_size must still include the elements of the tail.
+    void pushTailIntoTree(NodePtr tail)
+    {
+        if ((m_size >> Bits) > (std::size_t(1) << m_shift)) {
+            // The tree is full, add a level above the root.
+            auto root = std::make_shared<Node>();
+            root->children.push_back(std::move(m_root));
+            root->children.push_back(newPath(m_shift, std::move(tail)));
+            m_root = std::move(root);
+            m_shift += Bits;
+        } else {
+            m_root = pushTail(m_shift, m_root, std::move(tail));
+        }
+    }
+
+    NodePtr pushTail(unsigned level, const NodePtr &parent, NodePtr tail) const
+    {
+        auto node = parent ? std::make_shared<Node>(*parent) : std::make_shared<Node>();
+        const std::size_t subIndex = ((m_size - 1) >> level) & Mask;
+
+        NodePtr child;
+        if (level == Bits) {
+            child = std::move(tail);
+        } else if (subIndex < node->children.size()) {
+            child = pushTail(level - Bits, node->children[subIndex], std::move(tail));
+        } else {
+            child = newPath(level - Bits, std::move(tail));
+        }
+
+        if (subIndex < node->children.size()) {
+            node->children[subIndex] = std::move(child);
+        } else {
+            node->children.push_back(std::move(child));
+        }
+        return node;
+    }
+
+    // Removes the last leaf of the tree. m_size must still include the element that is removed.
+    NodePtr popTail(unsigned level, const NodePtr &node) const
+    {
+        const std::size_t subIndex = ((m_size - 2) >> level) & Mask;
+        if (level > Bits) {
+            NodePtr child = popTail(level - Bits, node->children[subIndex]);
+            if (!child && subIndex == 0) {
+                return nullptr;
+            }
+            auto copy = std::make_shared<Node>(*node);
+            if (child) {
+                copy->children[subIndex] = std::move(child);
+            } else {
+                copy->children.resize(subIndex);
+            }
+            return copy;
+        }
+        if (subIndex == 0) {
+            return nullptr;
+        }
+        auto copy = std::make_shared<Node>(*node);
+        copy->children.resize(subIndex);
+        return copy;
+    }
+
+    static NodePtr assign(unsigned level, const NodePtr &node, std::size_t index, T &&value)
+    {
+        auto copy = std::make_shared<Node>(*node);
+        if (level == 0) {
+            copy->values[index & Mask] = std::move(value);
+        } else {
+            const std::size_t subIndex = (index >> level) & Mask;
+            copy->children[subIndex] = assign(level - Bits, node->children[subIndex], index, std::move(value));
+        }
+        return copy;
+    }
+
+    static bool nodesEqual(const NodePtr &a, const NodePtr &b, unsigned level)
+    {
+        if (a == b) {
+            return true;
+        }
+        if (!a || !b) {
+            return false;
+        }
+        if (level == 0) {
+            return a->values == b->values;
+        }
+        if (a->children.size() != b->children.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a->children.size(); ++i) {
+            if (!nodesEqual(a->children[i], b->children[i], level - Bits)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    NodePtr m_root;
+    NodePtr m_tail;
+    std::size_t m_size = 0;
+    unsigned m_shift = Bits;
+};
+
+/**
+ * @brief An immutable hash map that shares its structure with the maps it was derived from.
+ *
+ * @warning The persistent containers are experimental and may be removed or changed in the future.
+ *
+ * The map is a hash array mapped trie, which consumes 5 bits of the hash of a key per level.
+ * Its nodes store entries and child nodes in two separate arrays (the CHAMP layout), which keeps
+ * the structure of the trie canonical: two maps with the same entries have the same structure,
+ * no matter in which order the entries were inserted.
+ * Keys whose hashes are identical are stored in a list at the bottom of the trie.
+ *
+ * Modifying functions like set() and erase() don't change the map, but return a new one, which
+ * only copies the nodes from the root to the modified entry, and shares everything else with
+ * the original. They take O(log32 n) time, which is effectively constant.
+ * Copying a PersistentMap is O(1).
+ *
+ * This makes it well suited as the value of a Property<T>: snapshots of the value and the old value
+ * that is passed to Property::valueAboutToChange() don't copy any entries, and comparing a new value
+ * with the previous one skips all shared subtrees, so it takes time proportional to the modified
+ * part of the map.
+ * If set() or erase() would not change the map, the map itself is returned, so assigning the result
+ * to a Property doesn't emit any Signals.
+ *
+ * Hash and KeyEqual must be default constructible and are constructed whenever they are needed.
+ * The order of iteration is unspecified, but the same for maps with the same entries.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class PersistentMap
+{
+    static constexpr unsigned Bits = 5;
+    static constexpr std::size_t Mask = (std::size_t(1) << Bits) - 1;
+    static constexpr unsigned HashBits = std::numeric_limits<std::size_t>::digits;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+
+private:
+    // Once all bits of the hash are consumed, a node only holds entries whose keys have the same
+    // hash, and neither bitmap is used.
+    struct Node {
+        std::uint32_t dataMap = 0;
+        std::uint32_t nodeMap = 0;
+        std::vector<value_type> entries;
+        std::vector<std::shared_ptr<const Node>> children;
+
+        bool isSingleton() const noexcept
+        {
+            return children.empty() && entries.size() == 1;
+        }
+    };
+    using NodePtr = std::shared_ptr<const Node>;
+
+public:
+    /** A forward iterator over the entries of a PersistentMap. */
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            return m_stack.back().node->entries[m_stack.back().position];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        const_iterator &operator++()
+        {
+            ++m_stack.back().position;
+            settle();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const noexcept
+        {
+            if (m_stack.empty() || other.m_stack.empty()) {
+                return m_stack.empty() == other.m_stack.empty();
+            }
+            return m_stack.back().node == other.m_stack.back().node && m_stack.back().position == other.m_stack.back().position;
+        }
+
+        bool operator!=(const const_iterator &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class PersistentMap;
+
+        // The position counts the entries of the node first, then its children.
+        struct Frame {
+            const Node *node;
+            std::size_t position;
+        };
+
+        explicit const_iterator(const Node *root)
+        {
+            if (root) {
+                m_stack.push_back({ root, 0 });
+                settle();
+            }
+        }
+
+        // Moves on until the top of the stack refers to an entry, or the stack is empty.
+        void settle()
+        {
+            while (!m_stack.empty()) {
+                Frame &frame = m_stack.back();
+                if (frame.position < frame.node->entries.size()) {
+                    return;
+                }
+                const std::size_t child = frame.position - frame.node->entries.size();
+                if (child < frame.node->children.size()) {
+                    ++frame.position;
+                    m_stack.push_back({ frame.node->children[child].get(), 0 });
+                } else {
+                    m_stack.pop_back();
+                }
+            }
+        }
+
+        std::vector<Frame> m_stack;
+    };
+
+    /** Constructs an empty PersistentMap. */
+    PersistentMap() = default;
+
+    /** Constructs a PersistentMap with the given entries. Later entries replace earlier ones with the same key. */
+    PersistentMap(std::initializer_list<value_type> entries)
+    {
+        for (const auto &entry : entries) {
+            *this = set(entry.first, entry.second);
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /** Returns a pointer to the value of the given key, or nullptr if the map doesn't contain the key. */
+    const Value *find(const Key &key) const
+    {
+        const Node *node = m_root.get();
+        if (!node) {
+            return nullptr;
+        }
+
+        const std::size_t hash = Hash{}(key);
+        for (unsigned shift = 0;; shift += Bits) {
+            if (shift >= HashBits) {
+                for (const auto &entry : node->entries) {
+                    if (KeyEqual{}(entry.first, key)) {
+                        return &entry.second;
+                    }
+                }
+                return nullptr;
+            }
+
+            const std::uint32_t bit = bitFor(hash, shift);
+            if (node->dataMap & bit) {
+                const auto &entry = node->entries[indexOf(node->dataMap, bit)];
+                return KeyEqual{}(entry.first, key) ? &entry.second : nullptr;
+            }
+            if (!(node->nodeMap & bit)) {
+                return nullptr;
+            }
+            node = node->children[indexOf(node->nodeMap, bit)].get();
+        }
+    }
+
+    bool contains(const Key &key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    std::size_t count(const Key &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * Returns the value of the given key.
+     *
+     * @throw std::out_of_range If the map doesn't contain the key.
+     */
+    const Value &at(const Key &key) const
+    {
+        if (const Value *value = find(key)) {
+            return *value;
+        }
+        throw std::out_of_range("PersistentMap doesn't contain the key");
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(m_root.get());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    /**
+     * Returns a map in which the given key has the given value.
+     *
+     * If the map already contains the key with a value that is equal_to the given one, this map is returned.
+     */
+    PersistentMap set(Key key, Value value) const
+    {
+        const std::size_t hash = Hash{}(key);
+        bool added = false;
+        NodePtr root = insert(m_root, value_type(std::move(key), std::move(value)), hash, 0, added);
+        if (root == m_root) {
+            return *this;
+        }
+
+        PersistentMap result;
+        result.m_root = std::move(root);
+        result.m_size = m_size + (added ? 1 : 0);
+        return result;
+    }
+
+    /** Returns a map without the given key, or this map if it doesn't contain the key. */
+    PersistentMap erase(const Key &key) const
+    {
+        if (!m_root) {
+            return *this;
+        }
+
+        NodePtr root = remove(m_root, key, Hash{}(key), 0);
+        if (root == m_root) {
+            return *this;
+        }
+
+        PersistentMap result;
+        result.m_size = m_size - 1;
+        if (result.m_size != 0) {
+            result.m_root = std::move(root);
+        }
+        return result;
+    }
+
+    /**
+     * Compares the entries of both maps.
+     *
+     * Subtrees that are shared by both maps are not compared entry by entry, so comparing a map with
+     * one derived from it takes time proportional to the number of modified entries.
+     */
+    template<typename U = Value>
+    auto operator==(const PersistentMap &other) const
+            -> std::enable_if_t<Private::are_equality_comparable_v<U, U>, bool>
+    {
+        return m_size == other.m_size && nodesEqual(m_root, other.m_root, 0);
+    }
+
+    template<typename U = Value>
+    auto operator!=(const PersistentMap &other) const
+            -> std::enable_if_t<Private::are_equality_comparable_v<U, U>, bool>
+    {
+        return !(*this == other);
+    }
+
+private:
+    static std::uint32_t bitFor(std::size_t hash, unsigned shift) noexcept
+    {
+        return std::uint32_t(1) << ((hash >> shift) & Mask);
+    }
+
+    static std::size_t indexOf(std::uint32_t bitmap, std::uint32_t bit) noexcept
+    {
+        return Private::popCount(bitmap & (bit - 1));
+    }
+
+    static NodePtr insert(const NodePtr &node, value_type &&entry, std::size_t hash, unsigned shift, bool &added)
+    {
+        if (shift >= HashBits) {
+            for (std::size_t i = 0; i < node->entries.size(); ++i) {
+                if (KeyEqual{}(node->entries[i].first, entry.first)) {
+                    if (equal_to<Value>{}(node->entries[i].second, entry.second)) {
+                        return node;
+                    }
+                    auto copy = std::make_shared<Node>(*node);
+                    copy->entries[i].second = std::move(entry.second);
+                    return copy;
+                }
+            }
+            auto copy = std::make_shared<Node>(*node);
+            copy->entries.push_back(std::move(entry));
+            added = true;
+            return copy;
+        }
+
+        const std::uint32_t bit = bitFor(hash, shift);
+        if (!node) {
+            auto leaf = std::make_shared<Node>();
+            leaf->dataMap = bit;
+            leaf->entries.push_back(std::move(entry));
+            added = true;
+            return leaf;
+        }
+
+        if (node->dataMap & bit) {
+            const std::size_t i = indexOf(node->dataMap, bit);
+            const value_type &existing = node->entries[i];
+            if (KeyEqual{}(existing.first, entry.first)) {
+                if (equal_to<Value>{}(existing.second, entry.second)) {
+                    return node;
+                }
+                auto copy = std::make_shared<Node>(*node);
+                copy->entries[i].second = std::move(entry.second);
+                return copy;
+            }
+
+            // Two different keys share the bit on this level, so both move into a new child node.
+            NodePtr child = merge(value_type(existing), Hash{}(existing.first), std::move(entry), hash, shift + Bits);
+            auto copy = std::make_shared<Node>(*node);
+            copy->entries.erase(copy->entries.begin() + static_cast<std::ptrdiff_t>(i));
+            copy->dataMap ^= bit;
+            copy->nodeMap |= bit;
+            copy->children.insert(copy->children.begin() + static_cast<std::ptrdiff_t>(indexOf(copy->nodeMap, bit)), std::move(child));
+            added = true;
+            return copy;
+        }
+
+        if (node->nodeMap & bit) {
+            const std::size_t i = indexOf(node->nodeMap, bit);
+            NodePtr child = insert(node->children[i], std::move(entry), hash, shift + Bits, added);
+            if (child == node->children[i]) {
+                return node;
+            }
+            auto copy = std::make_shared<Node>(*node);
+            copy->children[i] = std::move(child);
+            return copy;
+        }
+
+        auto copy = std::make_shared<Node>(*node);
+        copy->dataMap |= bit;
+        copy->entries.insert(copy->entries.begin() + static_cast<std::ptrdiff_t>(indexOf(copy->dataMap, bit)), std::move(entry));
+        added = true;
+        return copy;
+    }
+
+    static NodePtr merge(value_type &&a, std::size_t hashA, value_type &&b, std::size_t hashB, unsigned shift)
+    {
+        auto node = std::make_shared<Node>();
+        if (shift >= HashBits) {
+            node->entries.push_back(std::move(a));
+            node->entries.push_back(std::move(b));
+            return node;
+        }
+
+        const std::uint32_t bitA = bitFor(hashA, shift);
+        const std::uint32_t bitB = bitFor(hashB, shift);
+        if (bitA == bitB) {
+            node->nodeMap = bitA;
+            node->children.push_back(merge(std::move(a), hashA, std::move(b), hashB, shift + Bits));
+        } else {
+            node->dataMap = bitA | bitB;
+            node->entries.push_back(bitA < bitB ? std::move(a) : std::move(b));
+            node->entries.push_back(bitA < bitB ? std::move(b) : std::move(a));
+        }
+        return node;
+    }
+
+    // Returns the node itself if it doesn't contain the key.
+    // A child node that is left with a single entry is replaced by that entry, which keeps the trie canonical.
+    static NodePtr remove(const NodePtr &node, const Key &key, std::size_t hash, unsigned shift)
+    {
+        if (shift >= HashBits) {
+            for (std::size_t i = 0; i < node->entries.size(); ++i) {
+                if (KeyEqual{}(node->entries[i].first, key)) {
+                    auto copy = std::make_shared<Node>(*node);
+                    copy->entries.erase(copy->entries.begin() + static_cast<std::ptrdiff_t>(i));
+                    return copy;
+                }
+            }
+            return node;
+        }
+
+        const std::uint32_t bit = bitFor(hash, shift);
+        if (node->dataMap & bit) {
+            const std::size_t i = indexOf(node->dataMap, bit);
+            if (!KeyEqual{}(node->entries[i].first, key)) {
+                return node;
+            }
+            auto copy = std::make_shared<Node>(*node);
+            copy->entries.erase(copy->entries.begin() + static_cast<std::ptrdiff_t>(i));
+            copy->dataMap ^= bit;
+            return copy;
+        }
+
+        if (node->nodeMap & bit) {
+            const std::size_t i = indexOf(node->nodeMap, bit);
+            NodePtr child = remove(node->children[i], key, hash, shift + Bits);
+            if (child == node->children[i]) {
+                return node;
+            }
+            auto copy = std::make_shared<Node>(*node);
+            if (child->isSingleton()) {
+                copy->children.erase(copy->children.begin() + static_cast<std::ptrdiff_t>(i));
+                copy->nodeMap ^= bit;
+                copy->dataMap |= bit;
+                copy->entries.insert(copy->entries.begin() + static_cast<std::ptrdiff_t>(indexOf(copy->dataMap, bit)), child->entries.front());
+            } else {
+                copy->children[i] = std::move(child);
+            }
+            return copy;
+        }
+
+        return node;
+    }
+
+    static bool nodesEqual(const NodePtr &a, const NodePtr &b, unsigned shift)
+    {
+        if (a == b) {
+            return true;
+        }
+        if (!a || !b) {
+            return false;
+        }
+
+        if (shift >= HashBits) {
+            // The order of colliding entries depends on the order of insertion.
+            if (a->entries.size() != b->entries.size()) {
+                return false;
+            }
+            for (const auto &entry : a->entries) {
+                bool found = false;
+                for (const auto &other : b->entries) {
+                    if (KeyEqual{}(entry.first, other.first)) {
+                        found = entry.second == other.second;
+                        break;
+                    }
+                }
+                if (!found) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        if (a->dataMap != b->dataMap || a->nodeMap != b->nodeMap) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a->entries.size(); ++i) {
+            if (!KeyEqual{}(a->entries[i].first, b->entries[i].first) || !(a->entries[i].second == b->entries[i].second)) {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < a->children.size(); ++i) {
+            if (!nodesEqual(a->children[i], b->children[i], shift + Bits)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    NodePtr m_root;
+    std::size_t m_size = 0;
+};
+
+} // namespace KDBindings
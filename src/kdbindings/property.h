@@ -17,6 +17,7 @@
 #include <iostream>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace KDBindings {
 
@@ -110,6 +111,9 @@ struct equal_to {
 namespace Private {
 template<typename PropertyType>
 class PropertyNode;
+
+template<typename A, typename B, typename Forward, typename Backward>
+struct BidirectionalBindingState;
 }
 
 /**
@@ -183,6 +187,7 @@ public:
         , m_valueChanged(std::move(other.m_valueChanged))
         , m_destroyed(std::move(other.m_destroyed))
         , m_updater(std::move(other.m_updater))
+        , m_updaterSuspended(std::exchange(other.m_updaterSuspended, false))
     {
         // We do not move the m_moved signal yet so that objects interested in the moved-into
         // property can recreate any connections they need.
@@ -192,6 +197,7 @@ public:
             using namespace std::placeholders;
             m_updater->setUpdateFunction(
                     std::bind(&Property<T>::setHelper, this, _1));
+            m_updater->setObservedFunction(std::bind(&Property<T>::isObserved, this));
         }
 
         // Emit the moved signals for the moved from and moved to properties
@@ -212,12 +218,14 @@ public:
         m_valueChanged = std::move(other.m_valueChanged);
         m_destroyed = std::move(other.m_destroyed);
         m_updater = std::move(other.m_updater);
+        m_updaterSuspended = std::exchange(other.m_updaterSuspended, false);
 
         // If we have an updater, let it know how to update our internal value
         if (m_updater) {
             using namespace std::placeholders;
             m_updater->setUpdateFunction(
                     std::bind(&Property<T>::setHelper, this, _1));
+            m_updater->setObservedFunction(std::bind(&Property<T>::isObserved, this));
         }
 
         // Emit the moved signals for the moved from and moved to properties
@@ -255,11 +263,13 @@ public:
     Property &operator=(std::unique_ptr<UpdaterT> &&updater)
     {
         m_updater = std::move(updater);
+        m_updaterSuspended = false;
 
         // Let the updater know how to update our internal value
         using namespace std::placeholders;
         m_updater->setUpdateFunction(
                 std::bind(&Property<T>::setHelper, this, _1));
+        m_updater->setObservedFunction(std::bind(&Property<T>::isObserved, this));
 
         // Now synchronise our value with whatever the updator has right now.
         setHelper(m_updater->get());
@@ -278,6 +288,7 @@ public:
     void reset()
     {
         m_updater.reset();
+        m_updaterSuspended = false;
     }
 
     /**
@@ -285,15 +296,27 @@ public:
      *
      * The first emitted value is the current value of the Property.<br>
      * The second emitted value is the new value of the Property.
+     *
+     * Accessing this Signal counts as observing the Property, see get().
      */
-    Signal<const T &, const T &> &valueAboutToChange() const { return m_valueAboutToChange; }
+    Signal<const T &, const T &> &valueAboutToChange() const
+    {
+        catchUp();
+        return m_valueAboutToChange;
+    }
 
     /**
      * Returns a Signal that will be emitted after the value of the property changed.
      *
      * The emitted value is the current (new) value of the Property.
+     *
+     * Accessing this Signal counts as observing the Property, see get().
      */
-    Signal<const T &> &valueChanged() const { return m_valueChanged; }
+    Signal<const T &> &valueChanged() const
+    {
+        catchUp();
+        return m_valueChanged;
+    }
 
     /**
      * Returns a Signal that will be emitted when this Property is destructed.
@@ -331,9 +354,14 @@ public:
 
     /**
      * Returns the value represented by this Property.
+     *
+     * If the Property has a Binding that suspended its evaluation while the Property was
+     * unobserved (see Binding::setSuspendWhenUnobserved()), the Binding is evaluated first,
+     * so the returned value is always up to date.
      */
     T const &get() const
     {
+        catchUp();
         return m_value;
     }
 
@@ -358,8 +386,59 @@ public:
         return Property<T>::get();
     }
 
+    /**
+     * Reports the memory used by this Property.
+     *
+     * This includes the Property itself, the connection storage of its Signals
+     * and the memory used by its PropertyUpdater (e.g. a Binding), if it has one.
+     *
+     * Memory that the value of type T allocates itself is not included.
+     */
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(Property<T>);
+        usage += signalHeapUsage(m_valueAboutToChange);
+        usage += signalHeapUsage(m_valueChanged);
+        usage += signalHeapUsage(m_moved);
+        usage += signalHeapUsage(m_destroyed);
+        if (m_updater) {
+            usage += m_updater->memoryUsage();
+        }
+        return usage;
+    }
+
 private:
-    void setHelper(T value)
+    // The Signals are already part of sizeof(Property), so only count what they allocated.
+    template<typename SignalT>
+    static MemoryUsage signalHeapUsage(const SignalT &signal) noexcept
+    {
+        MemoryUsage usage = signal.memoryUsage();
+        usage.liveBytes -= sizeof(SignalT);
+        return usage;
+    }
+
+    // Lets a suspended updater bring our value up to date before it is observed.
+    // Updaters only suspend after isObserved() returned false, so usually no virtual call is needed.
+    void catchUp() const
+    {
+        if (m_updaterSuspended) {
+            m_updaterSuspended = false;
+            m_updater->catchUp();
+        }
+    }
+
+    bool isObserved() const noexcept
+    {
+        if (m_valueChanged.connectionCount() != 0 || m_valueAboutToChange.connectionCount() != 0) {
+            return true;
+        }
+        m_updaterSuspended = true;
+        return false;
+    }
+
+    // Takes an rvalue, so set() and the updater move the new value only once.
+    void setHelper(T &&value)
     {
         if (equal_to<T>{}(value, m_value))
             return;
@@ -376,8 +455,8 @@ private:
     mutable Signal<const T &, const T &> m_valueAboutToChange;
     mutable Signal<const T &> m_valueChanged; // By const ref so we can emit the signal for move-only types of T e.g. std::unique_ptr<int>
 
-    // The PropertyNode needs to be a friend class of the Property, as it needs
-    // access to the m_moved Signal.
+    // The PropertyNode and the state of a bidirectional binding need to be friends of the
+    // Property, as they need access to the m_moved Signal.
     // The decision to make this Signal private was made after the suggestion by
     // @jm4R who reported issues with the move constructors noexcept guarantee.
     // (https://github.com/KDAB/KDBindings/issues/24)
@@ -386,10 +465,13 @@ private:
     // keep track of moved Properties.
     template<typename PropertyType>
     friend class Private::PropertyNode;
+    template<typename A, typename B, typename Forward, typename Backward>
+    friend struct Private::BidirectionalBindingState;
     mutable Signal<Property<T> &> m_moved;
 
     mutable Signal<> m_destroyed;
     std::unique_ptr<PropertyUpdater<T>> m_updater;
+    mutable bool m_updaterSuspended = false;
 };
 
 /**
@@ -458,3 +540,8 @@ struct is_property : is_property_helper<std::decay_t<T>> {
  */
 
 } // namespace KDBindings
+
+#ifdef KDBINDINGS_EXTERN_TEMPLATES
+// Declares the instantiations that are provided by the KDBindingsCore library.
+#include <kdbindings/extern_templates.h>
+#endif
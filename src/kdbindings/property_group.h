@@ -0,0 +1,342 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include <kdbindings/node.h>
+#include <kdbindings/property.h>
+#include <kdbindings/property_updater.h>
+#include <kdbindings/signal.h>
+
+namespace KDBindings {
+
+template<typename... Ts>
+class PropertyGroup;
+
+namespace Private {
+
+// A node that refers to a single field of a PropertyGroup.
+// It is the PropertyGroup equivalent of a PropertyNode.
+template<typename Group, std::size_t I>
+class PropertyGroupFieldNode : public NodeInterface<typename Group::template FieldType<I>>
+{
+public:
+    using FieldType = typename Group::template FieldType<I>;
+
+    explicit PropertyGroupFieldNode(const Group &group)
+        : m_group(&group), m_parent(nullptr), m_dirty(false)
+    {
+        m_changedHandle = group.changed().connect([this](typename Group::Mask mask) {
+            if (mask & Group::template fieldMask<I>()) {
+                this->markDirty();
+            }
+        });
+        m_destroyedHandle = group.destroyed().connect([this]() { m_group = nullptr; });
+    }
+
+    // PropertyGroupFieldNodes can neither be copied nor moved, as their connections refer to them.
+    PropertyGroupFieldNode(const PropertyGroupFieldNode &) = delete;
+    PropertyGroupFieldNode(PropertyGroupFieldNode &&) = delete;
+
+    ~PropertyGroupFieldNode() override
+    {
+        m_changedHandle.disconnect();
+        m_destroyedHandle.disconnect();
+    }
+
+    const FieldType &evaluate() const override
+    {
+        if (!m_group) {
+            throw PropertyDestroyedError("The PropertyGroup this node refers to no longer exists!");
+        }
+
+        m_dirty = false;
+        return m_group->template get<I>();
+    }
+
+    MemoryUsage memoryUsage() const noexcept override
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(PropertyGroupFieldNode);
+        return usage;
+    }
+
+protected:
+    Dirtyable **parentVariable() override { return &m_parent; }
+    const bool *dirtyVariable() const override { return &m_dirty; }
+
+private:
+    const Group *m_group;
+    ConnectionHandle m_changedHandle;
+    ConnectionHandle m_destroyedHandle;
+
+    Dirtyable *m_parent;
+    mutable bool m_dirty;
+};
+
+} // namespace Private
+
+/**
+ * @brief A PropertyGroup stores several values like a struct and notifies about changes with a single Signal.
+ *
+ * @warning PropertyGroup is experimental and may be removed or changed in the future.
+ *
+ * A record that consists of many individual Property instances carries four Signals per field,
+ * and an observer that is interested in any change of the record must connect to every one of them.
+ * A PropertyGroup instead stores all of its fields contiguously in a std::tuple and only has a
+ * single changed() Signal, which is emitted with a bitmask of the fields that changed.
+ *
+ * The fields are accessed by their index, which is most readable when using an enum:
+ * @code
+ * enum PersonField { Name, Age };
+ * PropertyGroup<std::string, int> person("Jane", 42);
+ * person.changed().connect([](PropertyGroup<std::string, int>::Mask mask) { ... });
+ * person.set<Age>(43);
+ * @endcode
+ *
+ * Multiple fields can be changed with a single emission of changed() using update().
+ *
+ * Individual fields can take part in data binding.
+ * node() returns a Node that can be used in a binding expression like a Property,
+ * and bind() makes a field the target of a Binding.
+ *
+ * A PropertyGroup can neither be copied nor moved, as nodes and bindings refer to it.
+ *
+ * @tparam Ts The types of the fields. At most 64 fields are supported.
+ */
+template<typename... Ts>
+class PropertyGroup
+{
+    static_assert(sizeof...(Ts) <= 64, "A PropertyGroup supports at most 64 fields");
+
+public:
+    /** The type of the bitmask emitted by changed(). Bit I is set if field I changed. */
+    using Mask = std::uint64_t;
+
+    /** The type of the field with index I. */
+    template<std::size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    /** The number of fields in this PropertyGroup. */
+    static constexpr std::size_t fieldCount = sizeof...(Ts);
+
+    /** Returns the bit that represents the field with index I in a Mask. */
+    template<std::size_t I>
+    static constexpr Mask fieldMask() noexcept
+    {
+        static_assert(I < sizeof...(Ts), "Field index out of range");
+        return Mask(1) << I;
+    }
+
+    /** Constructs a PropertyGroup with default constructed fields. */
+    PropertyGroup() = default;
+
+    /** Constructs a PropertyGroup with the given field values. */
+    explicit PropertyGroup(Ts... values)
+        : m_values(std::move(values)...)
+    {
+    }
+
+    /** Emits the destroyed() Signal. */
+    ~PropertyGroup()
+    {
+        m_destroyed.emit();
+    }
+
+    /** A PropertyGroup cannot be copy constructed. */
+    PropertyGroup(const PropertyGroup &) = delete;
+    /** A PropertyGroup cannot be copy assigned. */
+    PropertyGroup &operator=(const PropertyGroup &) = delete;
+    /** A PropertyGroup cannot be move constructed. */
+    PropertyGroup(PropertyGroup &&) = delete;
+    /** A PropertyGroup cannot be move assigned. */
+    PropertyGroup &operator=(PropertyGroup &&) = delete;
+
+    /** Returns the value of the field with index I. */
+    template<std::size_t I>
+    const FieldType<I> &get() const
+    {
+        // Only updaters that skipped an update need to catch up, see bind().
+        if (m_suspendedFields & fieldMask<I>()) {
+            m_suspendedFields &= ~fieldMask<I>();
+            std::get<I>(m_updaters)->catchUp();
+        }
+        return std::get<I>(m_values);
+    }
+
+    /**
+     * Assigns a new value to the field with index I.
+     *
+     * If the new value is equal_to the existing value, nothing happens.
+     * Otherwise changed() is emitted, unless this happens inside of update().
+     * If the field is set while changed() is being emitted, e.g. by a slot or a Binding
+     * to another field of this group, changed() is emitted again once the current
+     * emission finished.
+     *
+     * @throw ReadOnlyProperty If the field is the target of a Binding.
+     */
+    template<std::size_t I>
+    void set(FieldType<I> value)
+    {
+        if (std::get<I>(m_updaters)) {
+            throw ReadOnlyProperty{
+                "Cannot set value on a read-only field. This field likely holds the result of a binding expression."
+            };
+        }
+        setHelper<I>(std::move(value));
+    }
+
+    /**
+     * @brief Calls the given function and emits changed() only once afterwards.
+     *
+     * All fields that are set within the function are combined into a single Mask,
+     * which is emitted when the function returns, if any field changed.
+     * Calls to update() may be nested, in which case the outermost call emits changed().
+     *
+     * If the function throws, changed() is still emitted for the fields that were changed
+     * before the exception was thrown.
+     */
+    template<typename Func>
+    void update(Func &&func)
+    {
+        ++m_updateDepth;
+        try {
+            std::forward<Func>(func)();
+        } catch (...) {
+            endUpdate();
+            throw;
+        }
+        endUpdate();
+    }
+
+    /**
+     * Returns a Signal that is emitted whenever any field changes.
+     *
+     * The emitted Mask has bit I set for every field I that changed, see fieldMask().
+     */
+    Signal<Mask> &changed() const { return m_changed; }
+
+    /** Returns a Signal that is emitted when this PropertyGroup is destructed. */
+    Signal<> &destroyed() const { return m_destroyed; }
+
+    /**
+     * Returns a Node that refers to the field with index I.
+     *
+     * The Node can be used in a binding expression just like a Property, e.g.
+     * `makeBoundProperty(group.node<Age>() + 1)`.
+     * Every Node holds one connection to changed().
+     */
+    template<std::size_t I>
+    Private::Node<FieldType<I>> node() const
+    {
+        return Private::Node<FieldType<I>>(std::make_unique<Private::PropertyGroupFieldNode<PropertyGroup, I>>(*this));
+    }
+
+    /**
+     * Makes the field with index I the target of a Binding or other PropertyUpdater.
+     *
+     * This immediately assigns the current value of the updater to the field.
+     * The field becomes read-only until unbind() is called.
+     */
+    template<std::size_t I, typename UpdaterT>
+    void bind(std::unique_ptr<UpdaterT> &&updater)
+    {
+        auto &fieldUpdater = std::get<I>(m_updaters);
+        fieldUpdater = std::move(updater);
+        m_suspendedFields &= ~fieldMask<I>();
+
+        fieldUpdater->setUpdateFunction([this](FieldType<I> &&value) { setHelper<I>(std::move(value)); });
+        fieldUpdater->setObservedFunction([this]() {
+            if (m_changed.connectionCount() != 0) {
+                return true;
+            }
+            m_suspendedFields |= fieldMask<I>();
+            return false;
+        });
+
+        setHelper<I>(fieldUpdater->get());
+    }
+
+    /**
+     * Disconnects the Binding of the field with index I, if it has one.
+     *
+     * The value of the field does not change.
+     */
+    template<std::size_t I>
+    void unbind()
+    {
+        std::get<I>(m_updaters).reset();
+        m_suspendedFields &= ~fieldMask<I>();
+    }
+
+    /** Returns whether the field with index I is the target of a Binding. */
+    template<std::size_t I>
+    bool hasBinding() const noexcept
+    {
+        return std::get<I>(m_updaters) != nullptr;
+    }
+
+private:
+    template<std::size_t I>
+    void setHelper(FieldType<I> &&value)
+    {
+        auto &field = std::get<I>(m_values);
+        if (equal_to<FieldType<I>>{}(value, field))
+            return;
+
+        field = std::move(value);
+        m_changedFields |= fieldMask<I>();
+        // While changed() is emitted, e.g. when a field is bound to another field of this group,
+        // the change is only recorded and emitted by the ongoing emitChanged() afterwards.
+        if (m_updateDepth == 0 && !m_emitting) {
+            emitChanged();
+        }
+    }
+
+    void endUpdate()
+    {
+        if (--m_updateDepth == 0 && !m_emitting) {
+            emitChanged();
+        }
+    }
+
+    // Emits changed() until the slots no longer change any fields.
+    void emitChanged()
+    {
+        m_emitting = true;
+        try {
+            Mask mask;
+            while ((mask = std::exchange(m_changedFields, 0)) != 0) {
+                m_changed.emit(mask);
+            }
+        } catch (...) {
+            m_emitting = false;
+            throw;
+        }
+        m_emitting = false;
+    }
+
+    std::tuple<Ts...> m_values;
+    std::tuple<std::unique_ptr<PropertyUpdater<Ts>>...> m_updaters;
+    Mask m_changedFields = 0;
+    // Fields whose updater skipped an update, because nobody was connected to changed().
+    mutable Mask m_suspendedFields = 0;
+    int m_updateDepth = 0;
+    bool m_emitting = false;
+    mutable Signal<Mask> m_changed;
+    mutable Signal<> m_destroyed;
+};
+
+} // namespace KDBindings
@@ -0,0 +1,174 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <kdbindings/connection_evaluator.h>
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+namespace KDBindings {
+
+template<typename T>
+class PropertyReplication;
+
+template<typename T>
+KDBINDINGS_WARN_UNUSED PropertyReplication<T> replicate(const Property<T> &source, Property<T> &target, const std::shared_ptr<ConnectionEvaluator> &evaluator);
+
+/**
+ * @brief A PropertyReplication keeps a target Property in sync with a source Property through a ConnectionEvaluator.
+ *
+ * @warning Property replication is experimental and may be removed or changed in the future.
+ *
+ * It is created by KDBindings::replicate() and stops the replication when it is destructed.
+ *
+ * Whenever the source Property changes, its new value is stored in the PropertyReplication,
+ * replacing any value that has not been published yet.
+ * Only the first change after a publication queues a slot invocation in the ConnectionEvaluator.
+ * When the ConnectionEvaluator evaluates that invocation, the latest value is moved into
+ * the target Property.
+ *
+ * Therefore the queue of the ConnectionEvaluator contains at most one entry per replication,
+ * no matter how often the source Property changes, and intermediate values are never
+ * assigned to the target Property.
+ */
+template<typename T>
+class PropertyReplication
+{
+public:
+    /** A default constructed PropertyReplication doesn't replicate anything. */
+    PropertyReplication() = default;
+
+    /** A PropertyReplication can not be copied. */
+    PropertyReplication(const PropertyReplication &) = delete;
+    /** A PropertyReplication can not be copied. */
+    PropertyReplication &operator=(const PropertyReplication &) = delete;
+
+    /** A PropertyReplication can be moved. */
+    PropertyReplication(PropertyReplication &&) noexcept = default;
+    /** A PropertyReplication can be moved. Any replication of this instance is stopped. */
+    PropertyReplication &operator=(PropertyReplication &&) noexcept = default;
+
+    /**
+     * Stops the replication.
+     *
+     * A value that was not yet published will no longer be published.
+     */
+    ~PropertyReplication() = default;
+
+    /** Returns whether this PropertyReplication is currently replicating a Property. */
+    bool isActive() const noexcept
+    {
+        return m_state && m_state->target;
+    }
+
+private:
+    friend PropertyReplication replicate<>(const Property<T> &, Property<T> &, const std::shared_ptr<ConnectionEvaluator> &);
+
+    struct State {
+        explicit State(Property<T> &targetProperty)
+            : target(&targetProperty)
+        {
+        }
+
+        // Called in the thread that changes the source Property.
+        void markDirty(const T &value)
+        {
+            bool wasDirty = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                wasDirty = latest.has_value();
+                latest = value;
+            }
+            if (!wasDirty) {
+                dirty.emit();
+            }
+        }
+
+        // Called by the ConnectionEvaluator.
+        void publish()
+        {
+            std::optional<T> value;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                value.swap(latest);
+            }
+            if (value && target) {
+                target->set(std::move(*value));
+            }
+        }
+
+        std::mutex mutex;
+        std::optional<T> latest;
+        Property<T> *target;
+
+        // Emitted once per publication, deferred to the ConnectionEvaluator.
+        Signal<> dirty;
+
+        ScopedConnection publishConnection;
+        ScopedConnection targetDestroyedConnection;
+        // Declared last, so the source is disconnected first on destruction.
+        ScopedConnection sourceConnection;
+    };
+
+    explicit PropertyReplication(std::unique_ptr<State> &&state)
+        : m_state(std::move(state))
+    {
+    }
+
+    std::unique_ptr<State> m_state;
+};
+
+/**
+ * @brief Replicates the value of a source Property into a target Property, coalescing intermediate changes.
+ *
+ * @warning Property replication is experimental and may be removed or changed in the future.
+ *
+ * This is typically used to mirror a Property that is owned by one thread into a Property owned
+ * by another thread.
+ * In comparison to connecting the valueChanged() Signal with Signal::connectDeferred(), only the
+ * latest value is published, so the ConnectionEvaluator never holds more than one queued
+ * invocation for this replication and the target Property is only set once per evaluation.
+ *
+ * The current value of the source Property is published on the next evaluation of the evaluator.
+ *
+ * @param source The Property to replicate. Its value is copied once per change.
+ * @param target The Property that receives the value. It is only modified by the evaluator.
+ *               It must not have a binding, otherwise publishing throws ReadOnlyProperty.
+ *               If the target is destroyed, the replication stops. Moving the target is not supported.
+ * @param evaluator The ConnectionEvaluator that publishes the values, usually evaluated by the
+ *                  thread that owns the target Property.
+ * @return A PropertyReplication that stops the replication when it is destructed.
+ *
+ * @note The replication must be destructed while the source Property is not being changed,
+ * just like a ConnectionHandle must not be disconnected while its Signal is emitted in another thread.
+ */
+template<typename T>
+KDBINDINGS_WARN_UNUSED PropertyReplication<T> replicate(const Property<T> &source, Property<T> &target, const std::shared_ptr<ConnectionEvaluator> &evaluator)
+{
+    using State = typename PropertyReplication<T>::State;
+    auto state = std::make_unique<State>(target);
+    auto *statePtr = state.get();
+
+    // The Signal belongs to the state, so disconnecting it when the state is destroyed also
+    // removes any invocation that is still queued in the evaluator.
+    state->publishConnection = statePtr->dirty.connectDeferred(evaluator, [statePtr]() { statePtr->publish(); });
+    state->targetDestroyedConnection = target.destroyed().connect([statePtr]() { statePtr->target = nullptr; });
+    state->sourceConnection = source.valueChanged().connect([statePtr](const T &value) { statePtr->markDirty(value); });
+
+    statePtr->markDirty(source.get());
+
+    return PropertyReplication<T>(std::move(state));
+}
+
+} // namespace KDBindings
@@ -13,6 +13,8 @@
 
 #include <functional>
 
+#include <kdbindings/memory_usage.h>
+
 namespace KDBindings {
 
 /**
@@ -61,6 +63,41 @@ public:
      * It is called from the Property constructor.
      */
     virtual T get() const = 0;
+
+    /**
+     * The Property will call this function when it is constructed and pass a std::function as argument
+     * that returns whether anybody is currently connected to the change Signals of the Property.
+     *
+     * A PropertyUpdater may use this to skip updates of a Property that nobody observes.
+     * It should only call the function when it is about to skip an update, as the Property
+     * calls catchUp() before it is observed again whenever the function returned false.
+     * The default implementation ignores the function.
+     */
+    virtual void setObservedFunction(std::function<bool()> const & /*isObserved*/) { }
+
+    /**
+     * The Property calls this function before its value or its change Signals are accessed,
+     * if the function passed to setObservedFunction() returned false since the last call.
+     *
+     * A PropertyUpdater that skipped updates because the Property was not observed must
+     * update the Property now.
+     * The default implementation does nothing.
+     */
+    virtual void catchUp() { }
+
+    /**
+     * Reports the memory used by this PropertyUpdater.
+     *
+     * It is called by Property::memoryUsage().
+     * The default implementation only reports the size of the PropertyUpdater base class.
+     * Subclasses that own additional memory should override this function.
+     */
+    virtual MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage;
+        usage.liveBytes = sizeof(PropertyUpdater);
+        return usage;
+    }
 };
 
 } // namespace KDBindings
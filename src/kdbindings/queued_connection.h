@@ -0,0 +1,76 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+#include <kdbindings/signal.h>
+#include <kdbindings/thread_event_loop.h>
+#include <kdbindings/utils.h>
+
+namespace KDBindings {
+
+/**
+ * @brief Establishes a queued connection, which evaluates the slot in the given thread.
+ *
+ * @warning Queued connections are experimental and may be removed or changed in the future.
+ *
+ * This is a deferred connection (see Signal::connectDeferred()) to the ThreadEventLoop that is
+ * registered for the target thread.
+ * When the Signal is emitted, the slot invocation is queued in that ThreadEventLoop
+ * and evaluated by the target thread.
+ * Once the ThreadEventLoop is destroyed, for example because the target thread finished,
+ * the connection disconnects itself the next time the Signal is emitted.
+ *
+ * Example:
+ * @code
+ * Signal<int> signal;
+ * auto handle = connectQueued(signal, [](int value) { ... }, worker.get_id());
+ * @endcode
+ *
+ * @param signal The Signal to connect to.
+ * @param slot A std::function that takes the signal's parameter types.
+ * @param targetThread The id of the thread that should evaluate the slot.
+ * @return An instance of ConnectionHandle, that can be used to disconnect
+ * or temporarily block the connection.
+ * @throw std::runtime_error If no ThreadEventLoop is registered for the target thread
+ * (see ThreadEventLoop::create()).
+ *
+ * @warning Connecting functions to a signal that throw an exception when called is currently undefined behavior.
+ * All connected functions should handle their own exceptions.
+ */
+template<typename... Args>
+KDBINDINGS_WARN_UNUSED ConnectionHandle connectQueued(Signal<Args...> &signal, Private::non_deduced_t<std::function<void(Args...)>> const &slot, std::thread::id targetThread)
+{
+    auto loop = ThreadEventLoop::forThread(targetThread);
+    if (!loop) {
+        throw std::runtime_error("No ThreadEventLoop is registered for the target thread!");
+    }
+    return signal.connectDeferred(loop, slot);
+}
+
+/**
+ * @brief Establishes a queued connection, which evaluates the slot in the calling thread.
+ *
+ * @warning Queued connections are experimental and may be removed or changed in the future.
+ *
+ * Behaves like connectQueued(signal, slot, std::this_thread::get_id()).
+ *
+ * @throw std::runtime_error If no ThreadEventLoop is registered for the calling thread.
+ */
+template<typename... Args>
+KDBINDINGS_WARN_UNUSED ConnectionHandle connectQueued(Signal<Args...> &signal, Private::non_deduced_t<std::function<void(Args...)>> const &slot)
+{
+    return connectQueued(signal, slot, std::this_thread::get_id());
+}
+
+} // namespace KDBindings
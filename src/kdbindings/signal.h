@@ -13,10 +13,12 @@
 
 #include <assert.h>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <forward_list>
+#include <vector>
 
 #ifdef emit
 static_assert(false, "KDBindings is not compatible with Qt's 'emit' keyword.\n"
@@ -30,6 +32,7 @@ static_assert(false, "KDBindings is not compatible with Qt's 'emit' keyword.\n"
 
 #include <kdbindings/connection_evaluator.h>
 #include <kdbindings/genindex_array.h>
+#include <kdbindings/memory_usage.h>
 #include <kdbindings/utils.h>
 
 #include <kdbindings/KDBindingsConfig.h>
@@ -40,6 +43,11 @@ static_assert(false, "KDBindings is not compatible with Qt's 'emit' keyword.\n"
  * All public parts of KDBindings are members of this namespace.
  */
 namespace KDBindings {
+
+namespace Private {
+struct SignalAccess;
+} // namespace Private
+
 /**
  * @brief A Signal provides a mechanism for communication between objects.
  *
@@ -80,7 +88,12 @@ class Signal
     class Impl : public Private::SignalImplBase
     {
     public:
-        Impl() noexcept { }
+        Impl() noexcept
+        {
+#ifdef KDBINDINGS_ENABLE_MEMORY_TRACKING
+            m_memoryTracker.update(sizeof(Impl));
+#endif
+        }
 
         ~Impl() noexcept { }
 
@@ -98,7 +111,7 @@ class Signal
         {
             Connection newConnection;
             newConnection.slot = slot;
-            return m_connections.insert(std::move(newConnection));
+            return insertConnection(std::move(newConnection));
         }
 
         // Establish a deferred connection between signal and slot, where ConnectionEvaluator object
@@ -115,15 +128,25 @@ class Signal
                     };
                     evaluatorPtr->enqueueSlotInvocation(handle, lambda);
                 } else {
-                    throw std::runtime_error("ConnectionEvaluator is no longer alive");
+                    // Without the evaluator, the slot can never be evaluated again.
+                    // Throwing here would leave the Signal in its emitting state, so drop the
+                    // invocation and the connection instead.
+                    handle.disconnect();
                 }
             };
 
+            return connectEvaluated(evaluator, deferredSlot);
+        }
+
+        // Establishes a connection whose slot queues its invocations in the evaluator.
+        // When the connection is disconnected, these invocations are removed from the evaluator.
+        Private::GenerationalIndex connectEvaluated(const std::shared_ptr<ConnectionEvaluator> &evaluator, std::function<void(ConnectionHandle &handle, Args...)> const &slot)
+        {
             Connection newConnection;
             newConnection.m_connectionEvaluator = evaluator;
-            newConnection.slotReflective = deferredSlot;
+            newConnection.slotReflective = slot;
 
-            return m_connections.insert(std::move(newConnection));
+            return insertConnection(std::move(newConnection));
         }
 
         Private::GenerationalIndex connectReflective(std::function<void(ConnectionHandle &handle, Args...)> const &slot)
@@ -131,7 +154,7 @@ class Signal
             Connection newConnection;
             newConnection.slotReflective = slot;
 
-            return m_connections.insert(std::move(newConnection));
+            return insertConnection(std::move(newConnection));
         }
 
         // Disconnects a previously connected function
@@ -148,6 +171,12 @@ class Signal
             if (idOpt.has_value()) {
                 auto id = idOpt.value();
 
+                // Slots of a parallel emission may disconnect concurrently.
+                std::unique_lock<std::mutex> parallelEmitLock;
+                if (m_parallelEmitMutex) {
+                    parallelEmitLock = std::unique_lock<std::mutex>(*m_parallelEmitMutex);
+                }
+
                 // Retrieve the connection associated with this id
                 auto connection = m_connections.get(id);
                 if (connection && m_isEmitting) {
@@ -189,6 +218,12 @@ class Signal
 
         bool blockConnection(const Private::GenerationalIndex &id, bool blocked) override
         {
+            // Slots of a parallel emission may block connections concurrently.
+            std::unique_lock<std::mutex> parallelEmitLock;
+            if (m_parallelEmitMutex) {
+                parallelEmitLock = std::unique_lock<std::mutex>(*m_parallelEmitMutex);
+            }
+
             Connection *connection = m_connections.get(id);
             if (connection) {
                 const bool wasBlocked = connection->blocked;
@@ -214,8 +249,36 @@ class Signal
             }
         }
 
+        MemoryUsage memoryUsage() const noexcept
+        {
+            MemoryUsage usage = m_connections.memoryUsage();
+            usage.liveBytes += sizeof(Impl);
+            return usage;
+        }
+
+        std::size_t connectionCount() const noexcept
+        {
+            return m_connections.size();
+        }
+
+        bool blockAll(bool blocked) noexcept
+        {
+            const bool wasBlocked = m_blocked;
+            m_blocked = blocked;
+            return wasBlocked;
+        }
+
+        bool isBlocked() const noexcept
+        {
+            return m_blocked;
+        }
+
         void emit(Args... p)
         {
+            if (m_blocked) {
+                return;
+            }
+
             if (m_isEmitting) {
                 throw std::runtime_error("Signal is already emitting, nested emits are not supported!");
             }
@@ -232,36 +295,60 @@ class Signal
                     const auto con = m_connections.get(*index);
 
                     if (!con->blocked) {
-                        if (con->slotReflective) {
-                            if (auto sharedThis = shared_from_this(); sharedThis) {
-                                ConnectionHandle handle(sharedThis, *index);
-                                con->slotReflective(handle, p...);
-                            }
-                        } else if (con->slot) {
-                            con->slot(p...);
-                        }
+                        callSlot(*index, *con, p...);
                     }
                 }
             }
             m_isEmitting = false;
 
-            if (m_disconnectedDuringEmit) {
-                m_disconnectedDuringEmit = false;
+            disconnectDeferred();
+        }
 
-                // Because m_connections is using a GenerationIndexArray, this loop can tolerate
-                // deletions inside the loop. So iterating over the array and deleting entries from it
-                // should not lead to undefined behavior.
-                for (auto i = decltype(numEntries){ 0 }; i < numEntries; ++i) {
-                    const auto index = m_connections.indexAtEntry(i);
+        // Calls the unblocked slots concurrently, by calling parallelFor(slotCount, callSlots).
+        // parallelFor must call callSlots(begin, end) for disjoint ranges that together cover
+        // [0, slotCount), and only return once all of these calls returned.
+        template<typename ParallelFor>
+        void emitConcurrently(ParallelFor &&parallelFor, Args... p)
+        {
+            if (m_blocked) {
+                return;
+            }
 
-                    if (index.has_value()) {
-                        const auto con = m_connections.get(index.value());
-                        if (con->toBeDisconnected) {
-                            disconnect(ConnectionHandle(shared_from_this(), index));
-                        }
-                    }
+            if (m_isEmitting) {
+                throw std::runtime_error("Signal is already emitting, nested emits are not supported!");
+            }
+
+            // The blocked state is only read here, as slots may change it concurrently later on.
+            std::vector<Private::GenerationalIndex> indices;
+            indices.reserve(m_connections.size());
+            const auto numEntries = m_connections.entriesSize();
+            for (auto i = decltype(numEntries){ 0 }; i < numEntries; ++i) {
+                const auto index = m_connections.indexAtEntry(i);
+                if (index && !m_connections.get(*index)->blocked) {
+                    indices.push_back(*index);
                 }
             }
+
+            std::mutex emitMutex;
+            m_isEmitting = true;
+            m_parallelEmitMutex = &emitMutex;
+
+            try {
+                parallelFor(indices.size(), [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        callSlot(indices[i], *m_connections.get(indices[i]), p...);
+                    }
+                });
+            } catch (...) {
+                m_parallelEmitMutex = nullptr;
+                m_isEmitting = false;
+                disconnectDeferred();
+                throw;
+            }
+
+            m_parallelEmitMutex = nullptr;
+            m_isEmitting = false;
+            disconnectDeferred();
         }
 
     private:
@@ -276,7 +363,55 @@ class Signal
             bool toBeDisconnected{ false };
         };
 
+        void callSlot(const Private::GenerationalIndex &index, Connection &connection, const Args &...p)
+        {
+            if (connection.slotReflective) {
+                if (auto sharedThis = shared_from_this(); sharedThis) {
+                    ConnectionHandle handle(sharedThis, index);
+                    connection.slotReflective(handle, p...);
+                }
+            } else if (connection.slot) {
+                connection.slot(p...);
+            }
+        }
+
+        // Disconnects the connections that were disconnected by a slot during the last emission.
+        void disconnectDeferred()
+        {
+            if (!m_disconnectedDuringEmit) {
+                return;
+            }
+            m_disconnectedDuringEmit = false;
+
+            // Because m_connections is using a GenerationIndexArray, this loop can tolerate
+            // deletions inside the loop. So iterating over the array and deleting entries from it
+            // should not lead to undefined behavior.
+            const auto numEntries = m_connections.entriesSize();
+            for (auto i = decltype(numEntries){ 0 }; i < numEntries; ++i) {
+                const auto index = m_connections.indexAtEntry(i);
+
+                if (index.has_value()) {
+                    const auto con = m_connections.get(index.value());
+                    if (con->toBeDisconnected) {
+                        disconnect(ConnectionHandle(shared_from_this(), index));
+                    }
+                }
+            }
+        }
+
+        Private::GenerationalIndex insertConnection(Connection &&connection)
+        {
+            const auto index = m_connections.insert(std::move(connection));
+#ifdef KDBINDINGS_ENABLE_MEMORY_TRACKING
+            m_memoryTracker.update(sizeof(Impl) + m_connections.memoryUsage().totalBytes());
+#endif
+            return index;
+        }
+
         mutable Private::GenerationalIndexArray<Connection> m_connections;
+#ifdef KDBINDINGS_ENABLE_MEMORY_TRACKING
+        Private::MemoryTracker m_memoryTracker;
+#endif
 
         // If a reflective slot disconnects itself, we need to make sure to not deconstruct the std::function
         // while it is still running.
@@ -291,6 +426,10 @@ class Signal
         // This is helped by using the m_disconnedDuringEmit flag to avoid unnecessary iterations.
         bool m_isEmitting = false;
         bool m_disconnectedDuringEmit = false;
+        // Blocks the entire Signal, independent of the blocked state of the individual connections.
+        bool m_blocked = false;
+        // Only set during emitParallel(), serializes the slots that disconnect or block connections.
+        std::mutex *m_parallelEmitMutex = nullptr;
     };
 
 public:
@@ -392,6 +531,8 @@ public:
      *
      * First argument to the function is reference to a shared pointer to the ConnectionEvaluator responsible for determining
      * when the slot should be executed.
+     * If the ConnectionEvaluator is destroyed, the connection disconnects itself the next time
+     * the Signal is emitted.
      *
      * @return An instance of ConnectionHandle, that can be used to disconnect
      * or temporarily block the connection.
@@ -493,7 +634,10 @@ public:
             // Once all connections are disconnected, we can release ownership of the Impl.
             // This does not destroy the Signal itself, just the Impl object.
             // If another slot is connected, another Impl object will be constructed.
-            m_impl.reset();
+            // A blocked Signal keeps its Impl, as the Impl stores the blocked state.
+            if (!m_impl->isBlocked()) {
+                m_impl.reset();
+            }
         }
         // If m_impl is nullptr, we don't have any connections to disconnect
     }
@@ -547,6 +691,59 @@ public:
         }
     }
 
+    /**
+     * Sets the block state of the entire Signal.
+     * If a Signal is blocked, emitting it will not call any of its slots,
+     * until the Signal is unblocked.
+     *
+     * In comparison to blocking every connection individually, this is a constant-time
+     * operation, independent of the number of connections.
+     * The blocked state of the individual connections is not changed.
+     * Connections that were blocked before the Signal was blocked will therefore
+     * stay blocked when the Signal is unblocked again.
+     *
+     * To temporarily block a Signal, consider using an instance of SignalBlocker,
+     * which offers a RAII-style implementation that makes sure the Signal is always
+     * returned to its original state.
+     *
+     * @param blocked Whether the Signal should be blocked from now on.
+     * @return Whether the Signal was previously blocked.
+     */
+    bool blockAll(bool blocked)
+    {
+        if (!m_impl) {
+            if (!blocked) {
+                return false;
+            }
+            ensureImpl();
+        }
+        return m_impl->blockAll(blocked);
+    }
+
+    /**
+     * Returns the number of slots that are currently connected to this Signal.
+     *
+     * Blocked connections are counted as well.
+     * This is useful to skip expensive work that only serves to produce the arguments of an emission,
+     * if nobody is listening anyway.
+     */
+    std::size_t connectionCount() const noexcept
+    {
+        return m_impl ? m_impl->connectionCount() : 0;
+    }
+
+    /**
+     * Checks whether the entire Signal is currently blocked.
+     *
+     * To change the blocked state of the Signal, call blockAll().
+     *
+     * @return Whether the Signal is currently blocked.
+     */
+    bool isBlocked() const noexcept
+    {
+        return m_impl && m_impl->isBlocked();
+    }
+
     /**
      * Emits the Signal, which causes all connected slots to be called,
      * as long as they are not blocked.
@@ -573,13 +770,54 @@ public:
         // if m_impl is nullptr, we don't have any slots connected, don't bother emitting
     }
 
+    /**
+     * Reports the memory used by this Signal.
+     *
+     * This includes the Signal itself, as well as the storage of its connections.
+     * Storage of connections that were disconnected is kept for reuse and reported
+     * as dead memory, so a Signal that went through many connect/disconnect cycles
+     * may report a large amount of dead memory.
+     *
+     * Captures of the connected slots are not included.
+     */
+    MemoryUsage memoryUsage() const noexcept
+    {
+        MemoryUsage usage;
+        if (m_impl) {
+            usage = m_impl->memoryUsage();
+        }
+        usage.liveBytes += sizeof(Signal);
+        return usage;
+    }
+
 private:
     friend class ConnectionHandle;
+    friend struct Private::SignalAccess;
+
+    ConnectionHandle connectEvaluated(const std::shared_ptr<ConnectionEvaluator> &evaluator, std::function<void(ConnectionHandle &, Args...)> const &slot)
+    {
+        ensureImpl();
+
+        return ConnectionHandle{ m_impl, m_impl->connectEvaluated(evaluator, slot) };
+    }
+
+    template<typename ParallelFor>
+    void emitConcurrently(ParallelFor &&parallelFor, Args... p) const
+    {
+        if (m_impl)
+            m_impl->emitConcurrently(std::forward<ParallelFor>(parallelFor), p...);
+    }
 
     void ensureImpl()
     {
         if (!m_impl) {
-            m_impl = std::make_shared<Impl>();
+            // Deliberately not using std::make_shared here.
+            // make_shared would put the Impl into the same allocation as the control block,
+            // which is only freed once the last weak_ptr is gone.
+            // As every ConnectionHandle holds a weak_ptr to the Impl, a single stale
+            // ConnectionHandle would then keep the entire Impl allocated after the Signal is destroyed.
+            // With a separate allocation, stale handles only keep the small control block alive.
+            m_impl = std::shared_ptr<Impl>(new Impl());
         }
     }
 
@@ -598,6 +836,44 @@ private:
     mutable std::shared_ptr<Impl> m_impl;
 };
 
+namespace Private {
+
+// Gives the Signal functionality that lives in its own header, like connectDelayed() or emitParallel(),
+// access to the internals of a Signal, so signal.h doesn't depend on timers or threads.
+struct SignalAccess {
+    // Returns a weak reference to the Impl of the Signal, creating it if necessary.
+    // The Impl can be emitted through it as long as the Signal is alive and has connections.
+    template<typename... Args>
+    static auto weakImpl(Signal<Args...> &signal)
+    {
+        signal.ensureImpl();
+        return std::weak_ptr<typename Signal<Args...>::Impl>(signal.m_impl);
+    }
+
+    // Connects a reflective slot that queues its invocations in the evaluator itself,
+    // using enqueueSlotInvocation(). Disconnecting removes the queued invocations again,
+    // just like for Signal::connectDeferred().
+    template<typename... Args>
+    static ConnectionHandle connectEvaluated(Signal<Args...> &signal, const std::shared_ptr<ConnectionEvaluator> &evaluator, non_deduced_t<std::function<void(ConnectionHandle &, Args...)>> const &slot)
+    {
+        return signal.connectEvaluated(evaluator, slot);
+    }
+
+    // Calls the unblocked slots of the Signal concurrently, see Signal::Impl::emitConcurrently().
+    template<typename ParallelFor, typename... Args>
+    static void emitConcurrently(const Signal<Args...> &signal, ParallelFor &&parallelFor, non_deduced_t<Args>... args)
+    {
+        signal.emitConcurrently(std::forward<ParallelFor>(parallelFor), args...);
+    }
+
+    static void enqueueSlotInvocation(ConnectionEvaluator &evaluator, const ConnectionHandle &handle, const std::function<void()> &slotInvocation)
+    {
+        evaluator.enqueueSlotInvocation(handle, slotInvocation);
+    }
+};
+
+} // namespace Private
+
 /**
  * @brief A ConnectionBlocker is a convenient RAII-style mechanism for temporarily blocking a connection.
  *
@@ -638,6 +914,61 @@ private:
     bool m_wasBlocked{ false };
 };
 
+/**
+ * @brief A SignalBlocker is a convenient RAII-style mechanism for temporarily blocking an entire Signal.
+ *
+ * When a SignalBlocker is constructed, it will block the Signal using Signal::blockAll().
+ *
+ * When it is destructed, it will return the Signal to the blocked state it was in
+ * before the SignalBlocker was constructed.
+ *
+ * In comparison to using a ConnectionBlocker for every connection of a Signal, a SignalBlocker
+ * takes constant time, independent of the number of connections.
+ *
+ * Example:
+ * @code
+ * Signal<int> signal;
+ * {
+ *     SignalBlocker blocker(signal);
+ *     signal.emit(42); // No slot is called
+ * }
+ * signal.emit(42); // All unblocked slots are called again
+ * @endcode
+ */
+template<typename... Args>
+class SignalBlocker
+{
+public:
+    /**
+     * Constructs a new SignalBlocker and blocks the given Signal.
+     *
+     * The Signal must outlive the SignalBlocker.
+     */
+    explicit SignalBlocker(Signal<Args...> &signal)
+        : m_signal{ signal }
+    {
+        m_wasBlocked = m_signal.blockAll(true);
+    }
+
+    /** A SignalBlocker cannot be copied */
+    SignalBlocker(const SignalBlocker &) = delete;
+    /** A SignalBlocker cannot be copied */
+    SignalBlocker &operator=(const SignalBlocker &) = delete;
+
+    /**
+     * Destructs the SignalBlocker and returns the Signal into the blocked state it was in
+     * before the SignalBlocker was constructed.
+     */
+    ~SignalBlocker()
+    {
+        m_signal.blockAll(m_wasBlocked);
+    }
+
+private:
+    Signal<Args...> &m_signal;
+    bool m_wasBlocked{ false };
+};
+
 /**
  * @example 01-simple-connection/main.cpp
  *
@@ -0,0 +1,206 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <kdbindings/signal.h>
+
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace KDBindings {
+
+namespace Private {
+
+// The class that a pointer to a data member or member function belongs to.
+template<typename MemberPointer>
+struct member_class;
+
+template<typename T, typename Class>
+struct member_class<T Class::*> {
+    using type = Class;
+};
+
+template<typename MemberPointer>
+using member_class_t = typename member_class<MemberPointer>::type;
+
+// Wraps a template argument value in a type, so values of unrelated types can be compared.
+template<auto Value>
+struct value_marker {
+};
+
+// The types Ts in the order of their first occurrence, without duplicates, appended to Result.
+template<typename Result, typename... Ts>
+struct unique_types {
+    using type = Result;
+};
+
+template<typename... Rs, typename T, typename... Ts>
+struct unique_types<std::tuple<Rs...>, T, Ts...>
+    : std::conditional_t<(std::is_same_v<T, Rs> || ...),
+                         unique_types<std::tuple<Rs...>, Ts...>,
+                         unique_types<std::tuple<Rs..., T>, Ts...>> {
+};
+
+template<typename Tuple>
+struct tuple_of_pointers;
+
+template<typename... Ts>
+struct tuple_of_pointers<std::tuple<Ts...>> {
+    using type = std::tuple<Ts *...>;
+};
+
+} // namespace Private
+
+/**
+ * @brief Describes a connection from a Signal member of one class to a member function of another,
+ * for use in a StaticConnectionTable.
+ *
+ * @warning Static connections are experimental and may be removed or changed in the future.
+ *
+ * @tparam SignalMember A pointer to a Signal data member, e.g. `&Sensor::measured`.
+ * @tparam SlotMember A pointer to a member function that can be called with the arguments of the Signal,
+ * e.g. `&Display::show`.
+ */
+template<auto SignalMember, auto SlotMember>
+struct StaticConnection {
+    static_assert(std::is_member_object_pointer_v<decltype(SignalMember)>, "SignalMember must be a pointer to a Signal data member");
+    static_assert(std::is_member_function_pointer_v<decltype(SlotMember)>, "SlotMember must be a pointer to a member function");
+
+    /** The class that contains the Signal. */
+    using Sender = Private::member_class_t<decltype(SignalMember)>;
+    /** The class whose member function is called. */
+    using Receiver = Private::member_class_t<decltype(SlotMember)>;
+
+    static constexpr auto signal = SignalMember;
+    static constexpr auto slot = SlotMember;
+};
+
+/**
+ * @brief A set of connections between components that is fixed at compile time.
+ *
+ * @warning Static connections are experimental and may be removed or changed in the future.
+ *
+ * Connecting a slot to a Signal at runtime stores the slot in a std::function, and emitting the
+ * Signal walks the list of connections and calls each slot through it.
+ * For wiring that never changes, e.g. "the measured Signal of the Sensor always calls Display::show",
+ * the StaticConnectionTable instead lists the connections as template arguments. Emitting a Signal
+ * through the table calls the statically connected member functions directly, so the compiler can
+ * inline them, and nothing is stored or connected at runtime.
+ *
+ * The table refers to one instance of every class that occurs as a Sender or Receiver of its connections.
+ * These instances are passed to the constructor, in any order.
+ *
+ * Emitting a Signal through the table with emit() first calls the statically connected slots in the
+ * order of the table, and then emits the Signal itself, which calls its ordinary dynamic connections.
+ * Static and dynamic connections can therefore be used on the same Signal.
+ * If the Signal is blocked (see Signal::blockAll()), neither kind of slot is called.
+ * Unlike dynamic connections, static connections can't be blocked or disconnected individually.
+ *
+ * Emitting the Signal directly with Signal::emit() only calls its dynamic connections.
+ *
+ * Example:
+ * @code
+ * using Wiring = StaticConnectionTable<
+ *         StaticConnection<&Sensor::measured, &Display::show>,
+ *         StaticConnection<&Sensor::measured, &Logger::log>>;
+ *
+ * Wiring wiring(sensor, display, logger);
+ * wiring.emit<&Sensor::measured>(21.5);
+ * @endcode
+ */
+template<typename... Connections>
+class StaticConnectionTable
+{
+    using Components = typename Private::unique_types<std::tuple<>, typename Connections::Sender..., typename Connections::Receiver...>::type;
+    using ComponentPointers = typename Private::tuple_of_pointers<Components>::type;
+
+public:
+    /**
+     * Creates the table for the given components.
+     *
+     * Exactly one instance of every Sender and Receiver class of the connections must be passed.
+     * The components must outlive the table.
+     */
+    template<typename... Cs>
+    explicit StaticConnectionTable(Cs &...components)
+        : m_components(pointersTo(std::forward_as_tuple(components...), static_cast<ComponentPointers *>(nullptr)))
+    {
+        static_assert(sizeof...(Cs) == std::tuple_size_v<Components>,
+                      "Exactly one instance of every Sender and Receiver class of the connections must be passed");
+    }
+
+    /** Returns the instance of the given component class that the table refers to. */
+    template<typename Component>
+    Component &component() const noexcept
+    {
+        return *std::get<Component *>(m_components);
+    }
+
+    /** Returns the number of static connections of the given Signal in this table. */
+    template<auto SignalMember>
+    static constexpr std::size_t connectionCount() noexcept
+    {
+        return (std::size_t(0) + ... + std::size_t(isConnectionOf<Connections, SignalMember>()));
+    }
+
+    /**
+     * Emits the Signal of the Sender component, calling the static connections of the Signal
+     * in the order of the table, followed by its dynamic connections.
+     *
+     * The same rules apply as for Signal::emit().
+     */
+    template<auto SignalMember, typename... Args>
+    void emit(Args &&...args) const
+    {
+        using Sender = Private::member_class_t<decltype(SignalMember)>;
+        emitSignal<SignalMember>(component<Sender>().*SignalMember, std::forward<Args>(args)...);
+    }
+
+private:
+    template<typename Connection, auto SignalMember>
+    static constexpr bool isConnectionOf() noexcept
+    {
+        return std::is_same_v<Private::value_marker<Connection::signal>, Private::value_marker<SignalMember>>;
+    }
+
+    template<typename Arguments, typename... Ts>
+    static ComponentPointers pointersTo(Arguments arguments, std::tuple<Ts *...> *)
+    {
+        return ComponentPointers(std::addressof(std::get<Ts &>(arguments))...);
+    }
+
+    template<auto SignalMember, typename... SignalArgs>
+    void emitSignal(const Signal<SignalArgs...> &signal, Private::non_deduced_t<SignalArgs>... args) const
+    {
+        if (signal.isBlocked()) {
+            return;
+        }
+        (callSlot<Connections, SignalMember>(args...), ...);
+        signal.emit(args...);
+    }
+
+    template<typename Connection, auto SignalMember, typename... SignalArgs>
+    void callSlot(SignalArgs &...args) const
+    {
+        if constexpr (isConnectionOf<Connection, SignalMember>()) {
+            using Receiver = typename Connection::Receiver;
+            static_assert(std::is_invocable_v<decltype(Connection::slot), Receiver &, SignalArgs &...>,
+                          "The slot of a static connection must be callable with the arguments of the Signal");
+            std::invoke(Connection::slot, component<Receiver>(), args...);
+        }
+    }
+
+    ComponentPointers m_components;
+};
+
+} // namespace KDBindings
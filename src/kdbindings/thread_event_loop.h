@@ -0,0 +1,212 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <kdbindings/connection_evaluator.h>
+
+namespace KDBindings {
+
+/**
+ * @brief A ConnectionEvaluator that is owned by a thread and evaluates its deferred connections in that thread.
+ *
+ * @warning Queued connections are experimental and may be removed or changed in the future.
+ *
+ * Every thread may create at most one ThreadEventLoop using ThreadEventLoop::create().
+ * The ThreadEventLoop is registered for the thread that created it, so that Signals can
+ * route slot invocations to it using connectQueued() by only naming the target thread.
+ *
+ * The owning thread then runs exec() to wait for and evaluate queued slot invocations until
+ * quit() is called.
+ * Alternatively, a thread that already has its own event loop may call evaluateDeferredConnections()
+ * whenever it sees fit.
+ *
+ * Each ThreadEventLoop only locks its own queue when a slot invocation is enqueued.
+ * The registry of event loops is only locked when a queued connection is made to another
+ * thread, never when a Signal is emitted.
+ *
+ * @see connectQueued()
+ */
+class ThreadEventLoop : public ConnectionEvaluator
+{
+public:
+    /**
+     * @brief Creates a new ThreadEventLoop and registers it for the calling thread.
+     *
+     * The ThreadEventLoop stays registered as long as it is alive.
+     *
+     * @throw std::logic_error If another ThreadEventLoop is already registered for the calling thread.
+     */
+    static std::shared_ptr<ThreadEventLoop> create()
+    {
+        if (current()) {
+            throw std::logic_error("A ThreadEventLoop is already registered for this thread!");
+        }
+
+        // The constructor is private, so std::make_shared can't be used.
+        std::shared_ptr<ThreadEventLoop> loop(new ThreadEventLoop());
+
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            registry()[loop->m_threadId] = { loop.get(), loop };
+        }
+        currentLoop() = loop;
+
+        return loop;
+    }
+
+    /**
+     * @brief Returns the ThreadEventLoop registered for the calling thread.
+     *
+     * This function does not need to lock the registry.
+     *
+     * @return The ThreadEventLoop of this thread, or nullptr if this thread has none.
+     */
+    static std::shared_ptr<ThreadEventLoop> current() noexcept
+    {
+        return currentLoop().lock();
+    }
+
+    /**
+     * @brief Returns the ThreadEventLoop registered for the given thread.
+     *
+     * This function is thread safe.
+     *
+     * @return The ThreadEventLoop of the given thread, or nullptr if that thread has none.
+     */
+    static std::shared_ptr<ThreadEventLoop> forThread(std::thread::id threadId)
+    {
+        if (threadId == std::this_thread::get_id()) {
+            return current();
+        }
+
+        std::lock_guard<std::mutex> lock(registryMutex());
+        const auto it = registry().find(threadId);
+        if (it != registry().end()) {
+            return it->second.loop.lock();
+        }
+        return nullptr;
+    }
+
+    /** Unregisters the ThreadEventLoop from its thread. */
+    ~ThreadEventLoop() override
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        const auto it = registry().find(m_threadId);
+        if (it != registry().end() && it->second.rawLoop == this) {
+            registry().erase(it);
+        }
+    }
+
+    /** Returns the id of the thread that owns this ThreadEventLoop. */
+    std::thread::id threadId() const noexcept
+    {
+        return m_threadId;
+    }
+
+    /**
+     * @brief Evaluates queued slot invocations as they arrive, until quit() is called.
+     *
+     * Must be called from the thread that owns this ThreadEventLoop.
+     * Slot invocations that are still queued when quit() is called are not evaluated,
+     * they remain queued until the next call to exec() or evaluateDeferredConnections().
+     */
+    void exec()
+    {
+        assert(std::this_thread::get_id() == m_threadId);
+
+        std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+        while (true) {
+            m_wakeUp.wait(lock, [this]() { return m_hasInvocations || m_quit; });
+            if (m_quit) {
+                m_quit = false;
+                return;
+            }
+            m_hasInvocations = false;
+
+            lock.unlock();
+            evaluateDeferredConnections();
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief Makes exec() return.
+     *
+     * If exec() is not currently running, the next call to exec() returns immediately.
+     * This function is thread safe, so it may be called from any thread, including from a slot
+     * that is evaluated by exec().
+     */
+    void quit()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeUpMutex);
+            m_quit = true;
+        }
+        m_wakeUp.notify_one();
+    }
+
+protected:
+    /** Wakes up exec() whenever a new slot invocation is queued. */
+    void onInvocationAdded() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeUpMutex);
+            m_hasInvocations = true;
+        }
+        m_wakeUp.notify_one();
+    }
+
+private:
+    ThreadEventLoop()
+        : m_threadId(std::this_thread::get_id())
+    {
+    }
+
+    struct RegistryEntry {
+        // The raw pointer is used to identify the loop in the destructor, where the weak_ptr is already expired.
+        const ThreadEventLoop *rawLoop;
+        std::weak_ptr<ThreadEventLoop> loop;
+    };
+
+    static std::map<std::thread::id, RegistryEntry> &registry()
+    {
+        static std::map<std::thread::id, RegistryEntry> registry;
+        return registry;
+    }
+
+    static std::mutex &registryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::weak_ptr<ThreadEventLoop> &currentLoop() noexcept
+    {
+        static thread_local std::weak_ptr<ThreadEventLoop> loop;
+        return loop;
+    }
+
+    const std::thread::id m_threadId;
+
+    std::mutex m_wakeUpMutex;
+    std::condition_variable m_wakeUp;
+    bool m_hasInvocations = false;
+    bool m_quit = false;
+};
+
+} // namespace KDBindings
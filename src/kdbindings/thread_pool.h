@@ -0,0 +1,215 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace KDBindings {
+
+/**
+ * @brief A fixed set of worker threads that run fork/join jobs, used by emitParallel().
+ *
+ * @warning ThreadPool is experimental and may be removed or changed in the future.
+ *
+ * A job consists of a number of independent tasks.
+ * Instead of assigning the tasks to threads up front, every participating thread claims the next
+ * unclaimed task when it finished its previous one. Threads that run short tasks therefore take
+ * over the remaining work of threads that are busy with long tasks.
+ *
+ * The thread that starts a job always participates in it, so a job makes progress even if all
+ * workers are busy, and jobs may be started from within the tasks of another job.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Starts the given number of worker threads.
+     *
+     * Together with the thread that starts a job, up to threadCount + 1 threads run its tasks.
+     * By default, one worker less than the number of hardware threads is started.
+     */
+    explicit ThreadPool(std::size_t threadCount = defaultThreadCount())
+    {
+        m_workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    /** Waits for the worker threads to finish. Must not be called while a job is running. */
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_wakeUp.notify_all();
+        for (auto &worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    /** A ThreadPool can not be copied. */
+    ThreadPool(const ThreadPool &) = delete;
+    /** A ThreadPool can not be copied. */
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    /** A ThreadPool can not be moved, as its workers refer to it. */
+    ThreadPool(ThreadPool &&) = delete;
+    /** A ThreadPool can not be moved, as its workers refer to it. */
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    /** Returns the number of worker threads. */
+    std::size_t threadCount() const noexcept
+    {
+        return m_workers.size();
+    }
+
+    /**
+     * @brief Calls task(i) for every i in [0, taskCount) and returns when all calls returned.
+     *
+     * The tasks are run concurrently by the calling thread and the worker threads, in no particular order.
+     *
+     * If a task throws, the remaining tasks are still run, and the first exception is rethrown
+     * by parallelFor() afterwards.
+     */
+    void parallelFor(std::size_t taskCount, const std::function<void(std::size_t)> &task)
+    {
+        if (taskCount == 0) {
+            return;
+        }
+
+        auto job = std::make_shared<Job>(task, taskCount);
+        if (taskCount > 1 && !m_workers.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_jobs.push_back(job);
+            }
+            if (taskCount - 1 >= m_workers.size()) {
+                m_wakeUp.notify_all();
+            } else {
+                for (std::size_t i = 0; i < taskCount - 1; ++i) {
+                    m_wakeUp.notify_one();
+                }
+            }
+        }
+
+        job->run();
+
+        {
+            std::unique_lock<std::mutex> lock(job->mutex);
+            job->finished.wait(lock, [&job]() { return job->remaining == 0; });
+        }
+
+        // The workers only drop jobs that have no unclaimed tasks left when they see them,
+        // so make sure this one doesn't stay in the queue.
+        if (taskCount > 1 && !m_workers.empty()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), job), m_jobs.end());
+        }
+
+        if (job->exception) {
+            std::rethrow_exception(job->exception);
+        }
+    }
+
+    /** Returns the number of worker threads that a default constructed ThreadPool starts. */
+    static std::size_t defaultThreadCount() noexcept
+    {
+        const unsigned hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+private:
+    struct Job {
+        Job(const std::function<void(std::size_t)> &jobTask, std::size_t count)
+            : task(jobTask), taskCount(count), remaining(count)
+        {
+        }
+
+        bool hasUnclaimedTasks() const noexcept
+        {
+            return nextTask.load(std::memory_order_relaxed) < taskCount;
+        }
+
+        // Claims and runs tasks until none are left.
+        void run()
+        {
+            std::size_t i;
+            while ((i = nextTask.fetch_add(1, std::memory_order_relaxed)) < taskCount) {
+                try {
+                    task(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!exception) {
+                        exception = std::current_exception();
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remaining == 0) {
+                    finished.notify_all();
+                }
+            }
+        }
+
+        // Only referenced, the thread that started the job keeps the function alive until it is finished.
+        const std::function<void(std::size_t)> &task;
+        const std::size_t taskCount;
+        std::atomic<std::size_t> nextTask{ 0 };
+
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::size_t remaining;
+        std::exception_ptr exception;
+    };
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            // Forget about jobs that are already fully claimed, they are finished by the threads running them.
+            while (!m_jobs.empty() && !m_jobs.front()->hasUnclaimedTasks()) {
+                m_jobs.pop_front();
+            }
+
+            if (m_jobs.empty()) {
+                if (m_quit) {
+                    return;
+                }
+                m_wakeUp.wait(lock);
+                continue;
+            }
+
+            auto job = m_jobs.front();
+            lock.unlock();
+            job->run();
+            lock.lock();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    bool m_quit = false;
+
+    std::vector<std::thread> m_workers;
+};
+
+} // namespace KDBindings
@@ -0,0 +1,129 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <kdbindings/connection_evaluator.h>
+#include <kdbindings/signal.h>
+#include <kdbindings/timer_scheduler.h>
+#include <kdbindings/utils.h>
+
+namespace KDBindings {
+
+/**
+ * @brief Establishes a deferred connection, whose slot invocations are queued after a delay.
+ *
+ * @warning Timers are experimental and may be removed or changed in the future.
+ *
+ * Whenever the Signal is emitted, a timer is scheduled in the TimerScheduler.
+ * When the timer fires, the slot invocation is queued in the ConnectionEvaluator, just like
+ * a deferred connection (see Signal::connectDeferred()) does immediately.
+ *
+ * Disconnecting the connection cancels all of its pending invocations, both those that
+ * wait for their timer and those that are already queued in the evaluator.
+ *
+ * If the TimerScheduler or the ConnectionEvaluator is destroyed, the connection disconnects
+ * itself the next time the Signal is emitted, and the emission is dropped.
+ *
+ * @param signal The Signal to connect to.
+ * @param evaluator The ConnectionEvaluator that evaluates the slot.
+ * @param scheduler The TimerScheduler that delays the slot invocations.
+ * @param delay The time between an emission and queueing its slot invocation.
+ * @param slot A std::function that takes the signal's parameter types.
+ * @return An instance of ConnectionHandle, that can be used to disconnect
+ * or temporarily block the connection.
+ *
+ * @note The arguments of every emission are copied and kept until the slot invocation is queued.
+ */
+template<typename... Args>
+KDBINDINGS_WARN_UNUSED ConnectionHandle connectDelayed(Signal<Args...> &signal,
+                                                       const std::shared_ptr<ConnectionEvaluator> &evaluator,
+                                                       const std::shared_ptr<TimerScheduler> &scheduler,
+                                                       TimerScheduler::Duration delay,
+                                                       Private::non_deduced_t<std::function<void(Args...)>> const &slot)
+{
+    // The pending timers only hold a weak reference to the slot, which dies with the
+    // connection. So timers of a disconnected connection don't queue any invocations.
+    auto sharedSlot = std::make_shared<const std::function<void(Args...)>>(slot);
+
+    auto delayedSlot = [weakEvaluator = std::weak_ptr<ConnectionEvaluator>(evaluator),
+                        weakScheduler = std::weak_ptr<TimerScheduler>(scheduler),
+                        delay,
+                        sharedSlot](ConnectionHandle &handle, Args... args) {
+        auto schedulerPtr = weakScheduler.lock();
+        if (!schedulerPtr || weakEvaluator.expired()) {
+            // Throwing from the slot would leave the Signal in its emitting state.
+            // As the invocations can never be evaluated, drop them and the connection instead.
+            handle.disconnect();
+            return;
+        }
+
+        auto weakSlot = std::weak_ptr<const std::function<void(Args...)>>(sharedSlot);
+        (void)schedulerPtr->schedule(delay, [weakEvaluator, weakSlot, handle, args...]() {
+            auto evaluatorPtr = weakEvaluator.lock();
+            auto slotPtr = weakSlot.lock();
+            if (evaluatorPtr && slotPtr) {
+                Private::SignalAccess::enqueueSlotInvocation(*evaluatorPtr, handle, [slotPtr, args...]() {
+                    (*slotPtr)(args...);
+                });
+            }
+        });
+    };
+
+    return Private::SignalAccess::connectEvaluated(signal, evaluator, delayedSlot);
+}
+
+/**
+ * @brief Emits the Signal with the given arguments once the delay has passed.
+ *
+ * @warning Timers are experimental and may be removed or changed in the future.
+ *
+ * The Signal is emitted by TimerScheduler::processTimers(), in the thread that calls it.
+ * The arguments are copied until then.
+ *
+ * If the Signal is destroyed, or all of its slots are disconnected, before the delay has passed,
+ * the emission is dropped.
+ *
+ * @return A TimerHandle that can be used to cancel the emission.
+ */
+template<typename... Args>
+TimerHandle emitAfter(Signal<Args...> &signal, TimerScheduler &scheduler, TimerScheduler::Duration delay, Private::non_deduced_t<Args>... args)
+{
+    return scheduler.schedule(delay, [weakImpl = Private::SignalAccess::weakImpl(signal), args...]() {
+        if (auto impl = weakImpl.lock()) {
+            impl->emit(args...);
+        }
+    });
+}
+
+/**
+ * @brief Emits the Signal with the given arguments every interval.
+ *
+ * @warning Timers are experimental and may be removed or changed in the future.
+ *
+ * The emissions stop when the returned TimerHandle is cancelled, or when the Signal is destroyed
+ * or all of its slots are disconnected.
+ *
+ * @return A TimerHandle that must be used to stop the periodic emission.
+ * @throw std::invalid_argument If the interval is not positive.
+ */
+template<typename... Args>
+KDBINDINGS_WARN_UNUSED TimerHandle emitPeriodically(Signal<Args...> &signal, TimerScheduler &scheduler, TimerScheduler::Duration interval, Private::non_deduced_t<Args>... args)
+{
+    return scheduler.schedulePeriodic(interval, [weakImpl = Private::SignalAccess::weakImpl(signal), args...]() {
+        if (auto impl = weakImpl.lock()) {
+            impl->emit(args...);
+        }
+    });
+}
+
+} // namespace KDBindings
@@ -0,0 +1,550 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <kdbindings/memory_usage.h>
+#include <kdbindings/utils.h>
+#include <kdbindings/KDBindingsConfig.h>
+
+namespace KDBindings {
+
+namespace Private {
+
+// A hierarchical timing wheel, see "Hashed and Hierarchical Timing Wheels" by Varghese and Lauck.
+//
+// Time is divided into ticks. The wheel consists of Levels levels of SlotsPerLevel slots each.
+// A timer is stored in the level whose range covers the distance to its deadline, in the slot
+// selected by the corresponding bits of its deadline.
+// Whenever the lower levels wrap around, the next slot of the level above is "cascaded",
+// i.e. its timers are redistributed into the lower levels.
+//
+// Every slot is an intrusive doubly linked list of timer nodes, which are stored in a vector and
+// referred to by index. This makes inserting and cancelling a timer O(1), independent of the
+// number of pending timers. Each timer is cascaded at most Levels - 1 times before it expires.
+//
+// The TimerWheel is always accessed through a TimerScheduler, which locks its mutex.
+class TimerWheel
+{
+public:
+    static constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+    struct TimerId {
+        std::uint32_t index = InvalidIndex;
+        std::uint32_t generation = 0;
+    };
+
+    TimerId insert(std::uint64_t deadline, std::uint64_t interval, std::function<void()> &&callback)
+    {
+        std::uint32_t index;
+        if (m_freeList != InvalidIndex) {
+            index = m_freeList;
+            m_freeList = m_nodes[index].next;
+        } else {
+            if (m_nodes.size() >= InvalidIndex) {
+                throw std::length_error("Too many pending timers");
+            }
+            index = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        auto &node = m_nodes[index];
+        node.callback = std::move(callback);
+        node.deadline = deadline;
+        node.interval = interval;
+        node.active = true;
+        ++m_pending;
+
+        link(index);
+        return { index, node.generation };
+    }
+
+    bool isActive(TimerId id) const noexcept
+    {
+        return id.index < m_nodes.size() && m_nodes[id.index].active && m_nodes[id.index].generation == id.generation;
+    }
+
+    // Returns the callback of the cancelled timer, so it can be destroyed outside of the lock.
+    std::function<void()> cancel(TimerId id)
+    {
+        if (!isActive(id)) {
+            return {};
+        }
+        unlink(id.index);
+        return release(id.index);
+    }
+
+    std::size_t pending() const noexcept
+    {
+        return m_pending;
+    }
+
+    std::uint64_t currentTick() const noexcept
+    {
+        return m_currentTick;
+    }
+
+    // Advances the wheel to the given tick and moves all timers whose deadline was reached to the
+    // list of timers that takeExpired() returns.
+    // Timers that expire while those are invoked are only returned after the next call to advance().
+    void advance(std::uint64_t targetTick)
+    {
+        advanceTo(targetTick);
+
+        while (m_expired != InvalidIndex) {
+            const auto index = m_expired;
+            unlink(index);
+            pushFront(m_firing, index);
+        }
+    }
+
+    // Removes the next expired timer and returns its callback.
+    // A periodic timer is re-inserted with its next deadline, so its callback is copied.
+    // Returns an empty function if no timer expired.
+    std::function<void()> takeExpired()
+    {
+        if (m_firing == InvalidIndex) {
+            return {};
+        }
+
+        const auto index = m_firing;
+        unlink(index);
+
+        auto &node = m_nodes[index];
+        if (node.interval != 0) {
+            node.deadline += node.interval;
+            link(index);
+            return node.callback;
+        }
+        return release(index);
+    }
+
+    std::size_t nodeCapacity() const noexcept
+    {
+        return m_nodes.capacity();
+    }
+
+    static constexpr std::size_t nodeSize() noexcept
+    {
+        return sizeof(Node);
+    }
+
+private:
+    static constexpr std::size_t Levels = 4;
+    static constexpr std::size_t SlotBits = 8;
+    static constexpr std::size_t SlotsPerLevel = std::size_t(1) << SlotBits;
+
+    struct Node {
+        std::function<void()> callback;
+        std::uint64_t deadline = 0;
+        std::uint64_t interval = 0;
+        std::uint32_t *list = nullptr;
+        std::uint32_t prev = InvalidIndex;
+        std::uint32_t next = InvalidIndex;
+        std::uint32_t generation = 0;
+        bool active = false;
+    };
+
+    void advanceTo(std::uint64_t targetTick)
+    {
+        if (m_pending == 0 && targetTick > m_currentTick) {
+            m_currentTick = targetTick;
+            return;
+        }
+
+        while (m_currentTick < targetTick) {
+            ++m_currentTick;
+
+            for (std::size_t level = 1; level < Levels; ++level) {
+                if ((m_currentTick & ((std::uint64_t(1) << (SlotBits * level)) - 1)) != 0) {
+                    break;
+                }
+                cascade(m_slots[level][slotIndex(m_currentTick, level)]);
+            }
+
+            // All remaining timers in the current slot of the lowest level expire now.
+            auto &head = m_slots[0][slotIndex(m_currentTick, 0)];
+            while (head != InvalidIndex) {
+                const auto index = head;
+                unlink(index);
+                pushFront(m_expired, index);
+            }
+        }
+    }
+
+    static std::size_t slotIndex(std::uint64_t tick, std::size_t level) noexcept
+    {
+        return static_cast<std::size_t>((tick >> (SlotBits * level)) & (SlotsPerLevel - 1));
+    }
+
+    void link(std::uint32_t index)
+    {
+        const auto deadline = m_nodes[index].deadline;
+        if (deadline <= m_currentTick) {
+            pushFront(m_expired, index);
+            return;
+        }
+
+        const auto distance = deadline - m_currentTick;
+        for (std::size_t level = 0; level < Levels; ++level) {
+            if (distance < (std::uint64_t(1) << (SlotBits * (level + 1)))) {
+                pushFront(m_slots[level][slotIndex(deadline, level)], index);
+                return;
+            }
+        }
+
+        // The deadline is beyond the range of the wheel. Park the timer in the slot of the top level
+        // that is cascaded last, it will be re-inserted from there.
+        const auto topLevel = Levels - 1;
+        pushFront(m_slots[topLevel][slotIndex(m_currentTick + (SlotsPerLevel - 1) * (std::uint64_t(1) << (SlotBits * topLevel)), topLevel)], index);
+    }
+
+    void pushFront(std::uint32_t &head, std::uint32_t index) noexcept
+    {
+        auto &node = m_nodes[index];
+        node.list = &head;
+        node.prev = InvalidIndex;
+        node.next = head;
+        if (head != InvalidIndex) {
+            m_nodes[head].prev = index;
+        }
+        head = index;
+    }
+
+    void unlink(std::uint32_t index) noexcept
+    {
+        auto &node = m_nodes[index];
+        if (node.prev != InvalidIndex) {
+            m_nodes[node.prev].next = node.next;
+        } else {
+            *node.list = node.next;
+        }
+        if (node.next != InvalidIndex) {
+            m_nodes[node.next].prev = node.prev;
+        }
+        node.list = nullptr;
+        node.prev = node.next = InvalidIndex;
+    }
+
+    void cascade(std::uint32_t &head)
+    {
+        while (head != InvalidIndex) {
+            const auto index = head;
+            unlink(index);
+            link(index);
+        }
+    }
+
+    std::function<void()> release(std::uint32_t index)
+    {
+        auto &node = m_nodes[index];
+        auto callback = std::move(node.callback);
+        node.callback = nullptr;
+        node.active = false;
+        ++node.generation;
+        node.next = m_freeList;
+        m_freeList = index;
+        --m_pending;
+        return callback;
+    }
+
+    std::vector<Node> m_nodes;
+    std::array<std::array<std::uint32_t, SlotsPerLevel>, Levels> m_slots = initialSlots();
+    // Timers whose deadline was reached, but which were not yet handed out by advance().
+    std::uint32_t m_expired = InvalidIndex;
+    // Timers handed out by advance(), returned one by one by takeExpired().
+    std::uint32_t m_firing = InvalidIndex;
+    std::uint32_t m_freeList = InvalidIndex;
+    std::size_t m_pending = 0;
+    std::uint64_t m_currentTick = 0;
+
+    static std::array<std::array<std::uint32_t, SlotsPerLevel>, Levels> initialSlots() noexcept
+    {
+        std::array<std::array<std::uint32_t, SlotsPerLevel>, Levels> slots;
+        for (auto &level : slots) {
+            level.fill(InvalidIndex);
+        }
+        return slots;
+    }
+};
+
+struct TimerSchedulerState {
+    std::mutex mutex;
+    TimerWheel wheel;
+};
+
+} // namespace Private
+
+/**
+ * @brief A TimerHandle refers to a timer of a TimerScheduler and can be used to cancel it.
+ *
+ * A default constructed TimerHandle doesn't refer to any timer.
+ * TimerHandles can be copied freely, cancelling a timer through any copy cancels it for all of them.
+ * A TimerHandle does not keep its TimerScheduler alive.
+ */
+class TimerHandle
+{
+public:
+    /** A TimerHandle can be default constructed, it is then inactive. */
+    TimerHandle() = default;
+
+    /**
+     * Returns whether the timer is still pending.
+     *
+     * A single-shot timer is no longer active once it fired, a periodic timer stays active until it is cancelled.
+     */
+    bool isActive() const
+    {
+        if (auto state = m_state.lock()) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            return state->wheel.isActive(m_id);
+        }
+        return false;
+    }
+
+    /**
+     * Cancels the timer in O(1), so it will not fire anymore.
+     *
+     * If the timer already fired or was cancelled, this function does nothing.
+     */
+    void cancel()
+    {
+        if (auto state = m_state.lock()) {
+            std::function<void()> callback;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                callback = state->wheel.cancel(m_id);
+            }
+            // The callback is destroyed outside of the lock, as its captures may run arbitrary code.
+        }
+        m_state.reset();
+    }
+
+private:
+    friend class TimerScheduler;
+
+    TimerHandle(std::weak_ptr<Private::TimerSchedulerState> state, Private::TimerWheel::TimerId id)
+        : m_state(std::move(state)), m_id(id)
+    {
+    }
+
+    std::weak_ptr<Private::TimerSchedulerState> m_state;
+    Private::TimerWheel::TimerId m_id;
+};
+
+/**
+ * @brief A TimerScheduler runs callbacks after a delay or periodically.
+ *
+ * @warning Timers are experimental and may be removed or changed in the future.
+ *
+ * The TimerScheduler does not own a thread.
+ * Instead, its owner calls processTimers() regularly, e.g. once per iteration of an event loop,
+ * or in a dedicated thread every resolution() interval.
+ * processTimers() invokes the callbacks of all timers whose deadline was reached,
+ * in the thread that called it.
+ *
+ * The timers are stored in a hierarchical timing wheel, so scheduling and cancelling a timer
+ * takes constant time, independent of the number of pending timers.
+ * The deadlines are rounded up to the resolution of the scheduler, which is one millisecond
+ * by default, and the wheel covers 2^32 ticks before timers need to be re-inserted, i.e.
+ * roughly 49 days at the default resolution.
+ *
+ * The clock of the TimerScheduler can be replaced, so that code using timers can be tested
+ * without actually waiting.
+ *
+ * Usually, the TimerScheduler is used through emitAfter(), emitPeriodically()
+ * and connectDelayed() from timed_emission.h.
+ *
+ * All functions of the TimerScheduler are thread safe.
+ */
+class TimerScheduler
+{
+public:
+    /** The type of durations used by the TimerScheduler. */
+    using Duration = std::chrono::nanoseconds;
+    /** The type of the clock function that tells the TimerScheduler the current time. */
+    using ClockFunction = std::function<std::chrono::steady_clock::time_point()>;
+
+    /**
+     * Constructs a TimerScheduler.
+     *
+     * @param resolution The length of a tick of the timing wheel. Deadlines are rounded up to multiples of it.
+     * @param clock The function used to determine the current time, by default std::chrono::steady_clock::now().
+     * @throw std::invalid_argument If the resolution is not positive.
+     */
+    explicit TimerScheduler(Duration resolution = std::chrono::milliseconds(1), ClockFunction clock = &std::chrono::steady_clock::now)
+        : m_resolution(resolution)
+        , m_clock(std::move(clock))
+        , m_start(m_clock())
+        , m_state(std::make_shared<Private::TimerSchedulerState>())
+    {
+        if (m_resolution <= Duration::zero()) {
+            throw std::invalid_argument("The resolution of a TimerScheduler must be positive");
+        }
+    }
+
+    /** A TimerScheduler is not copyable. */
+    TimerScheduler(const TimerScheduler &) = delete;
+    /** A TimerScheduler is not copyable. */
+    TimerScheduler &operator=(const TimerScheduler &) = delete;
+    /** A TimerScheduler is not movable, as Signals refer to it. */
+    TimerScheduler(TimerScheduler &&) = delete;
+    /** A TimerScheduler is not movable, as Signals refer to it. */
+    TimerScheduler &operator=(TimerScheduler &&) = delete;
+
+    /** Destroys the TimerScheduler, all pending timers are discarded without being invoked. */
+    ~TimerScheduler() = default;
+
+    /** Returns the resolution of this TimerScheduler. */
+    Duration resolution() const noexcept
+    {
+        return m_resolution;
+    }
+
+    /** Returns the current time, as reported by the clock of this TimerScheduler. */
+    std::chrono::steady_clock::time_point now() const
+    {
+        return m_clock();
+    }
+
+    /**
+     * Schedules a callback that is invoked once, after the given delay.
+     *
+     * A delay of zero invokes the callback in the next call to processTimers().
+     */
+    TimerHandle schedule(Duration delay, std::function<void()> callback)
+    {
+        return insert(deadlineAfter(delay), 0, std::move(callback));
+    }
+
+    /**
+     * Schedules a callback that is invoked every interval until the timer is cancelled.
+     *
+     * Every call to processTimers() invokes the callback at most once.
+     * If processTimers() is called less often than the interval, the timer falls behind
+     * and catches up with one invocation per subsequent call to processTimers().
+     *
+     * @throw std::invalid_argument If the interval is not positive.
+     */
+    KDBINDINGS_WARN_UNUSED TimerHandle schedulePeriodic(Duration interval, std::function<void()> callback)
+    {
+        if (interval <= Duration::zero()) {
+            throw std::invalid_argument("The interval of a periodic timer must be positive");
+        }
+        const auto intervalTicks = ticksFor(interval);
+        return insert(deadlineAfter(interval), intervalTicks, std::move(callback));
+    }
+
+    /**
+     * Invokes the callbacks of all timers whose deadline was reached.
+     *
+     * The callbacks are invoked in the calling thread, without holding any lock,
+     * so they may schedule and cancel timers themselves.
+     * Timers that are scheduled by a callback with a deadline that was already reached are
+     * only invoked in the next call to processTimers(), so a callback may safely reschedule
+     * itself with a delay of zero.
+     *
+     * @return The number of callbacks that were invoked.
+     */
+    std::size_t processTimers()
+    {
+        const auto targetTick = currentTick();
+
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->wheel.advance(targetTick);
+        }
+
+        std::size_t invoked = 0;
+        while (true) {
+            std::function<void()> callback;
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                callback = m_state->wheel.takeExpired();
+            }
+            if (!callback) {
+                break;
+            }
+            ++invoked;
+            callback();
+        }
+        return invoked;
+    }
+
+    /** Returns the number of timers that are currently pending. */
+    std::size_t pendingTimers() const
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->wheel.pending();
+    }
+
+    /**
+     * Reports the memory used by this TimerScheduler.
+     *
+     * Every pending timer occupies one slot. Slots of timers that fired or were cancelled are
+     * kept for reuse and reported as dead memory.
+     */
+    MemoryUsage memoryUsage() const
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        const auto &wheel = m_state->wheel;
+
+        MemoryUsage usage;
+        usage.liveSlots = wheel.pending();
+        usage.deadSlots = wheel.nodeCapacity() - usage.liveSlots;
+        usage.liveBytes = sizeof(TimerScheduler) + sizeof(Private::TimerSchedulerState) + usage.liveSlots * Private::TimerWheel::nodeSize();
+        usage.deadBytes = usage.deadSlots * Private::TimerWheel::nodeSize();
+        return usage;
+    }
+
+private:
+    std::uint64_t ticksFor(Duration duration) const
+    {
+        // Round up, so a timer never fires early.
+        const auto ticks = (duration + m_resolution - Duration(1)) / m_resolution;
+        return static_cast<std::uint64_t>(ticks > 0 ? ticks : 0);
+    }
+
+    std::uint64_t currentTick() const
+    {
+        const auto elapsed = m_clock() - m_start;
+        return elapsed > Duration::zero() ? static_cast<std::uint64_t>(elapsed / m_resolution) : 0;
+    }
+
+    std::uint64_t deadlineAfter(Duration delay) const
+    {
+        return currentTick() + ticksFor(delay);
+    }
+
+    TimerHandle insert(std::uint64_t deadline, std::uint64_t interval, std::function<void()> &&callback)
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        const auto id = m_state->wheel.insert(deadline, interval, std::move(callback));
+        return TimerHandle(m_state, id);
+    }
+
+    const Duration m_resolution;
+    const ClockFunction m_clock;
+    const std::chrono::steady_clock::time_point m_start;
+    std::shared_ptr<Private::TimerSchedulerState> m_state;
+};
+
+} // namespace KDBindings
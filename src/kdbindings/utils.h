@@ -117,6 +117,17 @@ KDBINDINGS_DEFINE_MEMBER_GET_ARITY(volatile const &noexcept)
 KDBINDINGS_DEFINE_MEMBER_GET_ARITY(volatile &&noexcept)
 KDBINDINGS_DEFINE_MEMBER_GET_ARITY(volatile const &&noexcept)
 
+// -------------------------- non_deduced ------------------------------
+// Prevents a function argument from taking part in template argument deduction,
+// e.g. so a lambda can be passed where a std::function of the Signal arguments is expected.
+template<typename T>
+struct non_deduced {
+    using type = T;
+};
+
+template<typename T>
+using non_deduced_t = typename non_deduced<T>::type;
+
 // -------------------- placeholder and bind_first ---------------------
 // Inspired by https://gist.github.com/engelmarkus/fc1678adbed1b630584c90219f77eb48
 // A placeholder provides a way to construct something equivalent to a std::placeholders::_N
@@ -10,14 +10,18 @@
 */
 
 #include "kdbindings/make_node.h"
+#include <kdbindings/bidirectional_binding.h>
 #include <kdbindings/binding.h>
+#include <kdbindings/binding_batch.h>
 #include <kdbindings/binding_evaluator.h>
+#include <kdbindings/computed_property.h>
 #include <kdbindings/node_operators.h>
 #include <kdbindings/node_functions.h>
 
 #include <iostream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
@@ -407,6 +411,369 @@ TEST_CASE("Binding reassignment")
     }
 }
 
+TEST_CASE("Rebinding")
+{
+    SUBCASE("An immediate Binding can be rebound to other Properties")
+    {
+        Property<int> a(1);
+        Property<int> b(2);
+        auto binding = makeBinding(a + b * 2);
+        auto *bindingPtr = binding.get();
+        Property<int> result(std::move(binding));
+        REQUIRE(result.get() == 5);
+
+        int changeCount = 0;
+        (void)result.valueChanged().connect([&changeCount]() { ++changeCount; });
+
+        Property<int> c(10);
+        Property<int> d(20);
+        bindingPtr->rebind(c, d);
+        REQUIRE(result.get() == 50);
+        REQUIRE(changeCount == 1);
+
+        // The old sources no longer affect the result
+        a = 100;
+        REQUIRE(result.get() == 50);
+
+        d = 1;
+        REQUIRE(result.get() == 12);
+    }
+
+    SUBCASE("A lazy Binding is re-evaluated by its evaluator after rebinding")
+    {
+        BindingEvaluator evaluator;
+        Property<int> a(1);
+        auto binding = makeBinding(evaluator, a * 2);
+        auto *bindingPtr = binding.get();
+        Property<int> result(std::move(binding));
+
+        Property<int> b(4);
+        bindingPtr->rebind(b);
+        REQUIRE(result.get() == 2);
+
+        evaluator.evaluateAll();
+        REQUIRE(result.get() == 8);
+    }
+
+    SUBCASE("Rebinding to mixed types and const Properties")
+    {
+        Property<std::string> label("a");
+        Property<int> count(1);
+        auto binding = makeBinding([](const std::string &s, int n) { return s + std::to_string(n); }, label, count);
+        auto *bindingPtr = binding.get();
+        Property<std::string> result(std::move(binding));
+
+        const Property<std::string> otherLabel("b");
+        Property<int> otherCount(2);
+        bindingPtr->rebind(otherLabel, otherCount);
+        REQUIRE(result.get() == "b2");
+    }
+
+    SUBCASE("Rebinding to a destroyed Property's replacement revives the Binding")
+    {
+        auto a = std::make_unique<Property<int>>(1);
+        auto binding = makeBinding(*a + 1);
+        auto *bindingPtr = binding.get();
+        Property<int> result(std::move(binding));
+
+        a.reset();
+        Property<int> b(5);
+        bindingPtr->rebind(b);
+        REQUIRE(result.get() == 6);
+    }
+
+    SUBCASE("Rebinding with mismatching Properties throws and leaves the Binding unchanged")
+    {
+        Property<int> a(1);
+        Property<int> b(2);
+        auto binding = makeBinding(a + b);
+        auto *bindingPtr = binding.get();
+        Property<int> result(std::move(binding));
+
+        Property<int> c(10);
+        Property<float> f(1.0f);
+        REQUIRE_THROWS_AS(bindingPtr->rebind(c), std::invalid_argument);
+        REQUIRE_THROWS_AS(bindingPtr->rebind(c, f), std::invalid_argument);
+
+        b = 3;
+        REQUIRE(result.get() == 4);
+    }
+}
+
+TEST_CASE("ComputedProperty")
+{
+    SUBCASE("A ComputedProperty is only evaluated when it is read")
+    {
+        Property<int> a(1);
+        int evaluations = 0;
+        auto computed = makeComputedProperty([&evaluations](int value) { ++evaluations; return value * 2; }, a);
+        REQUIRE(computed.get() == 2);
+        evaluations = 0;
+
+        a = 2;
+        a = 3;
+        a = 4;
+        REQUIRE(computed.isDirty());
+        REQUIRE(evaluations == 0);
+
+        REQUIRE(computed.get() == 8);
+        REQUIRE(computed() == 8);
+        REQUIRE(evaluations == 1);
+        REQUIRE_FALSE(computed.isDirty());
+    }
+
+    SUBCASE("A ComputedProperty with subscribers is evaluated eagerly")
+    {
+        Property<int> a(1);
+        Property<int> b(2);
+        auto computed = makeComputedProperty(a + b);
+
+        std::vector<int> values;
+        (void)computed.valueChanged().connect([&values](int value) { values.push_back(value); });
+
+        a = 5;
+        REQUIRE_FALSE(computed.isDirty());
+        REQUIRE(values == std::vector<int>{ 7 });
+
+        a = 6;
+        b = 1;
+        REQUIRE(values == std::vector<int>{ 7, 8, 7 });
+        REQUIRE(computed.get() == 7);
+    }
+
+    SUBCASE("A slot connected while a ComputedProperty is dirty is notified of later changes")
+    {
+        Property<int> a(1);
+        auto computed = makeComputedProperty(a * 2);
+
+        a = 2;
+        REQUIRE(computed.isDirty());
+
+        std::vector<int> values;
+        (void)computed.valueChanged().connect([&values](int value) { values.push_back(value); });
+        REQUIRE_FALSE(computed.isDirty());
+
+        a = 3;
+        REQUIRE(values == std::vector<int>{ 6 });
+        REQUIRE(computed.get() == 6);
+    }
+
+    SUBCASE("valueChanged is only emitted if the computed value changes")
+    {
+        Property<int> a(1);
+        auto computed = makeComputedProperty(a / 10);
+
+        std::vector<int> values;
+        (void)computed.valueChanged().connect([&values](int value) { values.push_back(value); });
+
+        a = 11;
+        a = 12;
+        REQUIRE(values == std::vector<int>{ 1 });
+    }
+
+    SUBCASE("Reading a ComputedProperty emits valueChanged only if the value changed")
+    {
+        Property<int> a(1);
+        auto computed = makeComputedProperty(a * 0);
+
+        int changes = 0;
+        (void)computed.valueChanged().connect([&changes]() { ++changes; });
+        a = 2;
+        REQUIRE(computed.get() == 0);
+        REQUIRE(changes == 0);
+    }
+
+    SUBCASE("Reading a ComputedProperty with a destroyed input throws")
+    {
+        auto a = std::make_unique<Property<int>>(1);
+        auto computed = makeComputedProperty(*a + 1);
+
+        *a = 2;
+        a.reset();
+        REQUIRE_THROWS_AS(computed.get(), PropertyDestroyedError);
+    }
+
+    SUBCASE("A ComputedProperty emits destroyed")
+    {
+        Property<int> a(1);
+        bool destroyed = false;
+        {
+            auto computed = makeComputedProperty(a + 1);
+            (void)computed.destroyed().connect([&destroyed]() { destroyed = true; });
+        }
+        REQUIRE(destroyed);
+    }
+}
+
+TEST_CASE("Suspending unobserved Bindings")
+{
+    SUBCASE("An unobserved immediate Binding is evaluated once when read")
+    {
+        Property<int> a(1);
+        int evaluations = 0;
+        auto binding = makeBinding([&evaluations](int value) { ++evaluations; return value * 2; }, a);
+        auto *bindingPtr = binding.get();
+        bindingPtr->setSuspendWhenUnobserved(true);
+        Property<int> result(std::move(binding));
+        evaluations = 0;
+
+        a = 2;
+        a = 3;
+        a = 4;
+        REQUIRE(bindingPtr->isSuspended());
+        REQUIRE(evaluations == 0);
+
+        REQUIRE(result.get() == 8);
+        REQUIRE(evaluations == 1);
+        REQUIRE_FALSE(bindingPtr->isSuspended());
+    }
+
+    SUBCASE("An observed Binding is evaluated on every change")
+    {
+        Property<int> a(1);
+        auto binding = makeBinding(a * 2);
+        binding->setSuspendWhenUnobserved(true);
+        Property<int> result(std::move(binding));
+
+        std::vector<int> values;
+        auto handle = result.valueChanged().connect([&values](int value) { values.push_back(value); });
+        a = 2;
+        a = 3;
+        REQUIRE(values == std::vector<int>{ 4, 6 });
+
+        handle.disconnect();
+        a = 4;
+        REQUIRE(values == std::vector<int>{ 4, 6 });
+
+        // Connecting again catches up before the connection is made
+        (void)result.valueChanged().connect([&values](int value) { values.push_back(value); });
+        REQUIRE(result.get() == 8);
+        a = 5;
+        REQUIRE(values == std::vector<int>{ 4, 6, 10 });
+    }
+
+    SUBCASE("A lazy Binding skips evaluation while unobserved")
+    {
+        BindingEvaluator evaluator;
+        Property<int> a(1);
+        int evaluations = 0;
+        auto binding = makeBinding(evaluator, [&evaluations](int value) { ++evaluations; return value + 1; }, a);
+        auto *bindingPtr = binding.get();
+        bindingPtr->setSuspendWhenUnobserved(true);
+        Property<int> result(std::move(binding));
+        evaluations = 0;
+
+        a = 5;
+        evaluator.evaluateAll();
+        REQUIRE(evaluations == 0);
+        REQUIRE(bindingPtr->isSuspended());
+
+        bindingPtr->setSuspendWhenUnobserved(false);
+        REQUIRE(evaluations == 1);
+        REQUIRE(result.get() == 6);
+    }
+
+    SUBCASE("A Binding that depends on a suspended Property keeps it observed")
+    {
+        Property<int> a(1);
+        auto binding = makeBinding(a + 1);
+        binding->setSuspendWhenUnobserved(true);
+        Property<int> intermediate(std::move(binding));
+        auto result = makeBoundProperty(intermediate * 10);
+
+        a = 2;
+        REQUIRE(result.get() == 30);
+    }
+}
+
+TEST_CASE("BindingBatch")
+{
+    Property<int> t(0);
+    auto positions = makeBindingBatch<int, int>([](int origin, int velocity, int time) { return origin + velocity * time; }, t);
+    std::vector<std::vector<std::size_t>> emissions;
+    (void)positions.resultsChanged().connect([&emissions](const std::vector<std::size_t> &rows) { emissions.push_back(rows); });
+
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(positions.addRow(i * 10, i % 2) == std::size_t(i));
+    }
+    REQUIRE(positions.size() == 8);
+    REQUIRE(positions.result(3) == 30);
+    REQUIRE_FALSE(positions.isDirty());
+
+    SUBCASE("Changing a uniform evaluates all rows, but only reports rows whose result changed")
+    {
+        t = 2;
+        REQUIRE(positions.isDirty());
+        // Nothing is computed before evaluate() is called
+        REQUIRE(positions.result(1) == 10);
+
+        REQUIRE(positions.evaluate() == 4);
+        REQUIRE(emissions == std::vector<std::vector<std::size_t>>{ { 1, 3, 5, 7 } });
+        REQUIRE(positions.result(1) == 12);
+        REQUIRE(positions.result(2) == 20);
+        REQUIRE_FALSE(positions.isDirty());
+
+        REQUIRE(positions.evaluate() == 0);
+        REQUIRE(emissions.size() == 1);
+    }
+
+    SUBCASE("Changing a column only evaluates that row")
+    {
+        positions.set<0>(6, 100);
+        positions.set<1>(2, 0); // unchanged
+        REQUIRE(positions.get<0>(6) == 100);
+        REQUIRE(positions.evaluate() == 1);
+        REQUIRE(emissions == std::vector<std::vector<std::size_t>>{ { 6 } });
+        REQUIRE(positions.result(6) == 100);
+    }
+
+    SUBCASE("A whole column can be modified at once")
+    {
+        t = 1;
+        positions.evaluate();
+        emissions.clear();
+
+        positions.modifyColumn<1>([](std::vector<int> &velocities) {
+            for (auto &velocity : velocities) {
+                velocity += 1;
+            }
+        });
+        REQUIRE(positions.evaluate() == 8);
+        REQUIRE(positions.results() == std::vector<int>{ 1, 12, 21, 32, 41, 52, 61, 72 });
+        REQUIRE(positions.column<1>() == std::vector<int>{ 1, 2, 1, 2, 1, 2, 1, 2 });
+    }
+
+    SUBCASE("Removing a row moves the last row into its place")
+    {
+        positions.set<0>(7, 5);
+        positions.removeRow(2);
+        REQUIRE(positions.size() == 7);
+        REQUIRE(positions.get<0>(2) == 5);
+
+        // The dirty state moved along with the row
+        REQUIRE(positions.evaluate() == 1);
+        REQUIRE(emissions == std::vector<std::vector<std::size_t>>{ { 2 } });
+        REQUIRE(positions.result(2) == 5);
+
+        REQUIRE_THROWS_AS(positions.removeRow(7), std::out_of_range);
+        REQUIRE_THROWS_AS(positions.set<0>(7, 1), std::out_of_range);
+    }
+
+    SUBCASE("Uniforms can be binding expressions")
+    {
+        Property<int> scale(2);
+        auto scaled = makeBindingBatch<int>([](int value, int factor) { return value * factor; }, scale * 3);
+        scaled.addRow(1);
+        scaled.addRow(2);
+        REQUIRE(scaled.results() == std::vector<int>{ 6, 12 });
+
+        scale = 1;
+        REQUIRE(scaled.evaluate() == 2);
+        REQUIRE(scaled.results() == std::vector<int>{ 3, 6 });
+        REQUIRE(scaled.memoryUsage().liveBytes > 0);
+    }
+}
+
 TEST_CASE("Expression node tree construction: operators")
 {
     SUBCASE("Unary op -")
@@ -698,6 +1065,140 @@ TEST_CASE("Expression node tree construction: functions")
     }
 }
 
+TEST_CASE("Bidirectional bindings")
+{
+    Property<double> celsius(100.0);
+    Property<double> fahrenheit(0.0);
+    int forwardCalls = 0;
+    int backwardCalls = 0;
+    int celsiusChanges = 0;
+    int fahrenheitChanges = 0;
+    (void)celsius.valueChanged().connect([&celsiusChanges](double) { ++celsiusChanges; });
+    (void)fahrenheit.valueChanged().connect([&fahrenheitChanges](double) { ++fahrenheitChanges; });
+
+    auto sync = bindBidirectional(
+            celsius, fahrenheit,
+            [&forwardCalls](double c) {
+                ++forwardCalls;
+                return c * 9 / 5 + 32;
+            },
+            [&backwardCalls](double f) {
+                ++backwardCalls;
+                return (f - 32) * 5 / 9;
+            });
+    REQUIRE(sync.isActive());
+
+    SUBCASE("The second Property is initialized from the first")
+    {
+        REQUIRE(fahrenheit.get() == 212.0);
+        REQUIRE(forwardCalls == 1);
+        REQUIRE(backwardCalls == 0);
+        REQUIRE(celsiusChanges == 0);
+    }
+
+    SUBCASE("Every change is propagated exactly once")
+    {
+        celsius = 0.0;
+        REQUIRE(fahrenheit.get() == 32.0);
+        REQUIRE(forwardCalls == 2);
+        REQUIRE(backwardCalls == 0);
+        REQUIRE(celsiusChanges == 1);
+        REQUIRE(fahrenheitChanges == 2);
+
+        fahrenheit = 50.0;
+        REQUIRE(celsius.get() == 10.0);
+        REQUIRE(forwardCalls == 2);
+        REQUIRE(backwardCalls == 1);
+        REQUIRE(celsiusChanges == 2);
+        REQUIRE(fahrenheitChanges == 3);
+    }
+
+    SUBCASE("Destroying the BidirectionalBinding stops the synchronization")
+    {
+        sync = BidirectionalBinding();
+        REQUIRE_FALSE(sync.isActive());
+        celsius = 0.0;
+        REQUIRE(fahrenheit.get() == 212.0);
+    }
+
+    SUBCASE("Destroying a Property stops the synchronization")
+    {
+        BidirectionalBinding outliving;
+        {
+            Property<double> temporary(1.0);
+            outliving = bindBidirectional(temporary, fahrenheit);
+            REQUIRE(fahrenheit.get() == 1.0);
+        }
+        fahrenheit = 2.0;
+        REQUIRE(fahrenheit.get() == 2.0);
+    }
+
+    SUBCASE("The synchronization follows moved Properties")
+    {
+        BidirectionalBinding movedSync;
+        std::unique_ptr<Property<double>> movedTo;
+        {
+            Property<double> original(1.0);
+            movedSync = bindBidirectional(original, fahrenheit);
+            movedTo = std::make_unique<Property<double>>(std::move(original));
+        }
+        REQUIRE(movedTo->get() == 1.0);
+
+        fahrenheit = 5.0;
+        REQUIRE(movedTo->get() == 5.0);
+        *movedTo = 6.0;
+        REQUIRE(fahrenheit.get() == 6.0);
+    }
+
+    SUBCASE("Move assigning another Property stops the synchronization")
+    {
+        Property<double> target(1.0);
+        auto targetSync = bindBidirectional(target, fahrenheit);
+        target = Property<double>(3.0);
+
+        fahrenheit = 5.0;
+        REQUIRE(target.get() == 3.0);
+    }
+}
+
+TEST_CASE("Bidirectional bindings with lossy conversions and Bindings")
+{
+    Property<double> model(1.4);
+    Property<int> view(0);
+    auto sync = bindBidirectional(
+            model, view, [](double value) { return static_cast<int>(value); }, [](int value) { return static_cast<double>(value); });
+    REQUIRE(view.get() == 1);
+    // The rounded value isn't propagated back
+    REQUIRE(model.get() == 1.4);
+
+    view = 3;
+    REQUIRE(model.get() == 3.0);
+
+    SUBCASE("A Property with a Binding is only read from")
+    {
+        Property<int> source(7);
+        Property<int> bound = makeBoundProperty(source * 2);
+        Property<int> mirror(0);
+        auto boundSync = bindBidirectional(mirror, bound);
+        REQUIRE(mirror.get() == 14);
+
+        source = 8;
+        REQUIRE(mirror.get() == 16);
+
+        // Doesn't throw ReadOnlyProperty
+        mirror = 1;
+        REQUIRE(bound.get() == 16);
+    }
+
+    SUBCASE("Two Properties with a Binding can't be synchronized")
+    {
+        Property<int> source(7);
+        Property<int> first = makeBoundProperty(source * 2);
+        Property<int> second = makeBoundProperty(source * 3);
+        REQUIRE_THROWS_AS((void)bindBidirectional(first, second), ReadOnlyProperty);
+    }
+}
+
 TEST_CASE("Binding evaluations")
 {
     SUBCASE("A manual mode binding is not evaluated until requested")
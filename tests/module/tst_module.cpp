@@ -0,0 +1,61 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+#include <memory>
+#include <string>
+
+import kdbindings;
+
+// The expansion of TEST_CASE from doctest leads to a clazy warning.
+// As this issue originates from doctest, disable the warning.
+// clazy:excludeall=non-pod-global-static
+
+using namespace KDBindings;
+
+TEST_CASE("The kdbindings module exports Signals")
+{
+    Signal<int> signal;
+    int val = 0;
+    ScopedConnection connection = signal.connect([&val](int value) { val += value; });
+
+    signal.emit(4);
+    REQUIRE(val == 4);
+
+    {
+        SignalBlocker blocker(signal);
+        signal.emit(4);
+    }
+    REQUIRE(val == 4);
+
+    auto evaluator = std::make_shared<ConnectionEvaluator>();
+    ScopedConnection deferred = signal.connectDeferred(evaluator, [&val](int value) { val += value; });
+    signal.emit(1);
+    REQUIRE(val == 5);
+    evaluator->evaluateDeferredConnections();
+    REQUIRE(val == 6);
+}
+
+TEST_CASE("The kdbindings module exports Properties and bindings")
+{
+    Property<int> a(2);
+    Property<int> b(3);
+    auto sum = makeBoundProperty((a + b) * 2);
+    REQUIRE(sum.get() == 10);
+
+    a = 5;
+    REQUIRE(sum.get() == 16);
+
+    Property<std::string> name(std::string("World"));
+    auto greeting = makeBoundProperty(concat(std::string("Hello, "), name));
+    REQUIRE(greeting.get() == "Hello, World");
+}
@@ -9,11 +9,16 @@
   Contact KDAB at <info@kdab.com> for commercial licensing options.
 */
 
+#include <kdbindings/binding.h>
 #include <kdbindings/node_functions.h>
 #include <kdbindings/node.h>
+#include <kdbindings/node_strings.h>
+#include <kdbindings/node_timeseries.h>
 #include <kdbindings/make_node.h>
 #include <kdbindings/property.h>
 
+#include <chrono>
+#include <stdexcept>
 #include <string>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
@@ -493,3 +498,368 @@ TEST_CASE("Test node functions")
     KDBINDINGS_NODE_FUNCTION_TEST(acos, float, 1.f, 0.f);
     KDBINDINGS_NODE_FUNCTION_TEST(atan, float, 0.f, 0.f);
 }
+
+TEST_CASE("String building nodes")
+{
+    SUBCASE("concat joins Properties, constants and numbers")
+    {
+        Property<std::string> prefix("[");
+        Property<std::string> name("answer");
+        Property<int> value(42);
+        auto node = concat(prefix, name, ": ", value, ']');
+        REQUIRE(node.evaluate() == "[answer: 42]");
+
+        value = -7;
+        REQUIRE(node.isDirty());
+        REQUIRE(node.evaluate() == "[answer: -7]");
+
+        Property<double> ratio(0.5);
+        Property<bool> flag(true);
+        auto numbers = concat(ratio, " ", flag, " ", std::string_view("view"));
+        REQUIRE(numbers.evaluate() == "0.5 true view");
+    }
+
+    SUBCASE("concat reuses its buffer")
+    {
+        Property<std::string> name("a rather long name that doesn't fit into the small string buffer");
+        auto node = concat("Name: ", name);
+        const auto *data = node.evaluate().data();
+
+        name = "short";
+        REQUIRE(node.evaluate() == "Name: short");
+        REQUIRE(node.evaluate().data() == data);
+    }
+
+    SUBCASE("concat accepts nested nodes")
+    {
+        Property<int> a(1);
+        auto node = concat("sum: ", a + 2);
+        REQUIRE(node.evaluate() == "sum: 3");
+        a = 5;
+        REQUIRE(node.evaluate() == "sum: 7");
+    }
+
+    SUBCASE("formatString replaces placeholders")
+    {
+        Property<std::string> name("copy");
+        Property<int> done(3);
+        Property<int> total(10);
+        auto node = formatString("{}: {} of {} {{{2}}}", name, done, total);
+        REQUIRE(node.evaluate() == "copy: 3 of 10 {10}");
+
+        done = 4;
+        REQUIRE(node.evaluate() == "copy: 4 of 10 {10}");
+    }
+
+    SUBCASE("formatString rejects malformed format strings")
+    {
+        Property<int> value(1);
+        REQUIRE_THROWS_AS(formatString("{} {}", value), std::invalid_argument);
+        REQUIRE_THROWS_AS(formatString("{1}", value), std::invalid_argument);
+        REQUIRE_THROWS_AS(formatString("{", value), std::invalid_argument);
+        REQUIRE_THROWS_AS(formatString("}", value), std::invalid_argument);
+        REQUIRE_THROWS_AS(formatString("{x}", value), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Intermediate nodes")
+{
+    auto square = [](int &calls) {
+        return [&calls](int x) {
+            ++calls;
+            return x * x;
+        };
+    };
+
+    SUBCASE("Nested nodes keep their cache by default")
+    {
+        Property<int> a(1);
+        Property<int> b(2);
+        int calls = 0;
+
+        auto tree = Private::makeNode(square(calls), a) + b;
+        calls = 0;
+
+        b = 3;
+        REQUIRE(tree.evaluate() == 4);
+        REQUIRE(calls == 0);
+    }
+
+    SUBCASE("uncached() drops the caches of nested nodes of cheap types")
+    {
+        Property<int> a(1);
+        Property<int> b(2);
+
+        auto cachedTree = (a + b) * 2;
+        auto intermediateTree = uncached((a + b) * 2);
+        REQUIRE(intermediateTree.evaluate() == 6);
+        REQUIRE(intermediateTree.memoryUsage().liveBytes < cachedTree.memoryUsage().liveBytes);
+
+        a = 5;
+        REQUIRE(intermediateTree.isDirty());
+        REQUIRE(intermediateTree.evaluate() == 14);
+        REQUIRE(cachedTree.evaluate() == 14);
+    }
+
+    SUBCASE("Intermediate nodes are recomputed, cached nodes only if their inputs changed")
+    {
+        Property<int> a(1);
+        Property<int> b(2);
+        int intermediateCalls = 0;
+        int cachedCalls = 0;
+
+        auto intermediateTree = uncached(Private::makeNode(square(intermediateCalls), a) + b);
+        auto cachedTree = uncached(cached(Private::makeNode(square(cachedCalls), a)) + b);
+        intermediateCalls = 0;
+        cachedCalls = 0;
+
+        b = 3;
+        REQUIRE(intermediateTree.evaluate() == 4);
+        REQUIRE(cachedTree.evaluate() == 4);
+        REQUIRE(intermediateCalls == 1);
+        REQUIRE(cachedCalls == 0);
+    }
+
+    SUBCASE("Intermediate nodes are smaller than cached nodes")
+    {
+        REQUIRE(sizeof(Private::IntermediateOperatorNode<int, std::plus<>, int, int>) < sizeof(Private::OperatorNode<int, std::plus<>, int, int>));
+        REQUIRE(sizeof(Private::IntermediateOperatorNode<double, std::plus<>, double, double>) < sizeof(Private::OperatorNode<double, std::plus<>, double, double>));
+
+        Property<double> a(1.0);
+        Property<double> b(2.0);
+        REQUIRE(uncached((a + b) * 2.0).memoryUsage().liveBytes < ((a + b) * 2.0).memoryUsage().liveBytes);
+    }
+
+    SUBCASE("Intermediate nodes can be evaluated")
+    {
+        Property<int> a(1);
+        Private::IntermediateOperatorNode<int, std::negate<>, int> node(std::negate<>{}, std::make_tuple(Private::makeNode(a)));
+
+        a = 2;
+        REQUIRE(node.evaluate() == -2);
+        REQUIRE(node.value() == -2);
+    }
+
+    SUBCASE("Expensive to copy values are always cached")
+    {
+        Property<std::string> a("a");
+        int calls = 0;
+        auto tree = uncached(Private::makeNode([&calls](const std::string &value) { ++calls; return value + "b"; }, a) + std::string("c"));
+        calls = 0;
+
+        REQUIRE(tree.evaluate() == "abc");
+        REQUIRE(calls == 0);
+    }
+}
+
+TEST_CASE("Time series nodes")
+{
+    using namespace std::chrono_literals;
+    auto now = std::chrono::steady_clock::time_point();
+    auto scheduler = std::make_shared<TimerScheduler>(1ms, [&now]() { return now; });
+
+    SUBCASE("movingAverage averages the samples within the window")
+    {
+        Property<int> value(10);
+        auto average = movingAverage(value, 3s, scheduler, 16);
+        REQUIRE(average.evaluate() == 10.0);
+
+        now += 1s;
+        value = 20;
+        REQUIRE(average.isDirty());
+        REQUIRE(average.evaluate() == 15.0);
+
+        now += 1s;
+        value = 30;
+        REQUIRE(average.evaluate() == 20.0);
+
+        // The first sample at 0s leaves the window that now starts at 1s
+        now += 2s;
+        value = 40;
+        REQUIRE(average.evaluate() == 30.0);
+    }
+
+    SUBCASE("movingAverage drops the oldest samples if the capacity is exceeded")
+    {
+        Property<int> value(0);
+        auto average = movingAverage(value, 1s, scheduler, 2);
+        value = 10;
+        value = 20;
+        REQUIRE(average.evaluate() == 15.0);
+        REQUIRE(average.memoryUsage().totalBytes() < 1024);
+    }
+
+    SUBCASE("Samples leave the window while the Property doesn't change")
+    {
+        Property<int> value(10);
+        auto average = makeBoundProperty(movingAverage(value, 2s, scheduler, 16));
+        now += 1s;
+        value = 20;
+        now += 1s;
+        value = 30;
+        REQUIRE(average.get() == 20.0);
+
+        // The window now covers 0.5s to 2.5s
+        now += 500ms;
+        scheduler->processTimers();
+        REQUIRE(average.get() == 25.0);
+
+        // Only the value the Property still holds is left
+        now += 1s;
+        scheduler->processTimers();
+        REQUIRE(average.get() == 30.0);
+        REQUIRE(scheduler->pendingTimers() == 0);
+    }
+
+    SUBCASE("rate divides the change of the value by the elapsed time")
+    {
+        Property<int> counter(0);
+        auto perSecond = rate(counter, 10s, scheduler, 64);
+        REQUIRE(perSecond.evaluate() == 0.0);
+
+        now += 2s;
+        counter = 100;
+        REQUIRE(perSecond.evaluate() == 50.0);
+
+        now += 10s;
+        counter = 150;
+        // The sample at 0s left the window, so the rate is computed from 2s to 12s
+        REQUIRE(perSecond.evaluate() == 5.0);
+    }
+
+    SUBCASE("rate falls to 0 once the Property stops changing")
+    {
+        Property<int> counter(0);
+        auto perSecond = makeBoundProperty(rate(counter, 1s, scheduler));
+        for (int i = 1; i <= 10; ++i) {
+            now += 100ms;
+            counter = i;
+        }
+        REQUIRE(perSecond.get() == doctest::Approx(10.0));
+
+        now += 1s;
+        scheduler->processTimers();
+        REQUIRE(perSecond.get() == 0.0);
+    }
+
+    SUBCASE("windowMin and windowMax track the extremes within the window")
+    {
+        Property<int> value(5);
+        auto minimum = windowMin(value, 2s, scheduler, 16);
+        auto maximum = windowMax(value, 2s, scheduler, 16);
+
+        const std::vector<int> values{ 3, 8, 6, 7, 4 };
+        const std::vector<int> expectedMin{ 3, 3, 3, 6, 4 };
+        const std::vector<int> expectedMax{ 5, 8, 8, 8, 7 };
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            now += 1s;
+            value = values[i];
+            REQUIRE(minimum.evaluate() == expectedMin[i]);
+            REQUIRE(maximum.evaluate() == expectedMax[i]);
+        }
+
+        now += 3s;
+        scheduler->processTimers();
+        REQUIRE(minimum.evaluate() == 4);
+        REQUIRE(maximum.evaluate() == 4);
+    }
+
+    SUBCASE("ewma weights values by how long they were held")
+    {
+        Property<double> value(0.0);
+        auto average = ewma(value, 1s, scheduler);
+        REQUIRE(average.evaluate() == 0.0);
+
+        // The value 0 was held for one time constant, the new value wasn't held yet
+        now += 1s;
+        value = 1.0;
+        REQUIRE(average.evaluate() == 0.0);
+
+        // The value 1 was held for one time constant
+        now += 1s;
+        scheduler->processTimers();
+        REQUIRE(average.isDirty());
+        REQUIRE(average.evaluate() == doctest::Approx(1.0 - std::exp(-1.0)));
+
+        // A value that is replaced without any time passing has no weight
+        value = 100.0;
+        value = 1.0;
+        now += 1s;
+        scheduler->processTimers();
+        REQUIRE(average.evaluate() == doctest::Approx(1.0 - std::exp(-2.0)));
+    }
+
+    SUBCASE("ewma handles uneven intervals between changes")
+    {
+        Property<double> value(0.0);
+        auto average = ewma(value, 2s, scheduler);
+
+        double expected = 0.0;
+        double held = 0.0;
+        auto change = [&](std::chrono::milliseconds elapsed, double newValue) {
+            now += elapsed;
+            value = newValue;
+            expected = held + (expected - held) * std::exp(-std::chrono::duration<double>(elapsed).count() / 2.0);
+            held = newValue;
+        };
+
+        change(500ms, 4.0);
+        REQUIRE(average.evaluate() == 0.0);
+        change(3000ms, -2.0);
+        REQUIRE(average.evaluate() == doctest::Approx(4.0 * (1.0 - std::exp(-1.5))));
+        change(100ms, 10.0);
+        REQUIRE(average.evaluate() == doctest::Approx(expected));
+
+        // A long interval lets the held value dominate the average, a short one barely moves it
+        change(20s, 1.0);
+        REQUIRE(average.evaluate() == doctest::Approx(expected));
+        REQUIRE(std::abs(average.evaluate() - 10.0) < 1e-3);
+        change(1ms, 5.0);
+        REQUIRE(average.evaluate() == doctest::Approx(expected));
+        REQUIRE(average.evaluate() > 9.99);
+    }
+
+    SUBCASE("ewma reaches the held value while the Property doesn't change")
+    {
+        Property<double> value(0.0);
+        auto average = makeBoundProperty(ewma(value, 1s, scheduler));
+        value = 1.0;
+
+        for (int i = 0; i < 100 && scheduler->pendingTimers() != 0; ++i) {
+            now += 1s;
+            scheduler->processTimers();
+        }
+        REQUIRE(scheduler->pendingTimers() == 0);
+        REQUIRE(average.get() == 1.0);
+    }
+
+    SUBCASE("Time series nodes can be used in bindings")
+    {
+        Property<int> value(2);
+        auto doubled = makeBoundProperty(movingAverage(value, 1s, scheduler, 16) * 2.0);
+        REQUIRE(doubled.get() == 4.0);
+
+        value = 4;
+        REQUIRE(doubled.get() == 6.0);
+    }
+
+    SUBCASE("Destroying a time series cancels its timer")
+    {
+        Property<int> value(0);
+        {
+            auto average = movingAverage(value, 1s, scheduler);
+            value = 1;
+            REQUIRE(scheduler->pendingTimers() == 1);
+        }
+        REQUIRE(scheduler->pendingTimers() == 0);
+    }
+
+    SUBCASE("Invalid parameters throw")
+    {
+        Property<int> value(0);
+        REQUIRE_THROWS_AS(movingAverage(value, 0s, scheduler, 16), std::invalid_argument);
+        REQUIRE_THROWS_AS(windowMax(value, 1s, scheduler, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(ewma(value, -1s, scheduler), std::invalid_argument);
+        REQUIRE_THROWS_AS(rate(value, 1s, nullptr), std::invalid_argument);
+    }
+}
@@ -9,9 +9,23 @@
   Contact KDAB at <info@kdab.com> for commercial licensing options.
 */
 
+#include <kdbindings/binding.h>
+#include <kdbindings/change_feed.h>
+#include <kdbindings/mapped_file_property.h>
+#include <kdbindings/persistent_containers.h>
 #include <kdbindings/property.h>
+#include <kdbindings/property_group.h>
+#include <kdbindings/property_replication.h>
+#include <kdbindings/thread_event_loop.h>
 
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <sstream>
+#include <map>
 #include <string>
+#include <thread>
+#include <vector>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
@@ -229,6 +243,44 @@ private:
     int m_value;
 };
 
+// Skips updates while the Property is unobserved and counts how often it has to catch up.
+class SuspendingPropertyUpdater : public PropertyUpdater<int>
+{
+public:
+    void setUpdateFunction(std::function<void(int &&)> const &updateFunction) override
+    {
+        m_updateFunction = updateFunction;
+    }
+
+    void setObservedFunction(std::function<bool()> const &isObserved) override
+    {
+        m_isObserved = isObserved;
+    }
+
+    int get() const override { return m_value; }
+
+    void catchUp() override
+    {
+        ++catchUpCalls;
+        m_updateFunction(int(m_value));
+    }
+
+    void set(int value)
+    {
+        m_value = value;
+        if (m_isObserved()) {
+            m_updateFunction(int(m_value));
+        }
+    }
+
+    int catchUpCalls = 0;
+
+private:
+    std::function<void(int &&)> m_updateFunction;
+    std::function<bool()> m_isObserved;
+    int m_value = 0;
+};
+
 TEST_CASE("Property Updaters")
 {
     SUBCASE("Can construct a property with an updater and the property assumes its value")
@@ -262,6 +314,30 @@ TEST_CASE("Property Updaters")
         REQUIRE(updatedValue == 123);
     }
 
+    SUBCASE("A property only asks its updater to catch up after it skipped an update")
+    {
+        auto updater = new SuspendingPropertyUpdater();
+        Property<int> property{ std::unique_ptr<SuspendingPropertyUpdater>(updater) };
+
+        REQUIRE(property.get() == 0);
+        (void)property.valueChanged();
+        REQUIRE(updater->catchUpCalls == 0);
+
+        updater->set(1);
+        updater->set(2);
+        REQUIRE(updater->catchUpCalls == 0);
+        REQUIRE(property.get() == 2);
+        REQUIRE(property.get() == 2);
+        REQUIRE(updater->catchUpCalls == 1);
+
+        int observed = 0;
+        auto handle = property.valueChanged().connect([&observed](int value) { observed = value; });
+        updater->set(3);
+        REQUIRE(observed == 3);
+        REQUIRE(property.get() == 3);
+        REQUIRE(updater->catchUpCalls == 1);
+    }
+
     SUBCASE("Can query a property to see if it has an updater")
     {
         Property<int> property(std::make_unique<DummyPropertyUpdater>(7));
@@ -272,6 +348,27 @@ TEST_CASE("Property Updaters")
     }
 }
 
+// Counts how often values of this type are copied and moved.
+struct MoveCounter {
+    MoveCounter() = default;
+    MoveCounter(const MoveCounter &) { ++copies; }
+    MoveCounter(MoveCounter &&) noexcept { ++moves; }
+    MoveCounter &operator=(const MoveCounter &)
+    {
+        ++copies;
+        return *this;
+    }
+    MoveCounter &operator=(MoveCounter &&) noexcept
+    {
+        ++moves;
+        return *this;
+    }
+    bool operator==(const MoveCounter &) const { return false; }
+
+    static inline int copies = 0;
+    static inline int moves = 0;
+};
+
 TEST_CASE("Moving")
 {
     SUBCASE("move constructed property holds the correct value")
@@ -290,6 +387,29 @@ TEST_CASE("Moving")
         REQUIRE(*(movedToProperty.get()) == 42);
     }
 
+    SUBCASE("Setting a value moves it into the Property without copies")
+    {
+        Property<MoveCounter> property;
+        MoveCounter::copies = 0;
+        MoveCounter::moves = 0;
+
+        // The argument of set() is moved into the stored value, without any moves in between
+        property.set(MoveCounter());
+        REQUIRE(MoveCounter::copies == 0);
+        REQUIRE(MoveCounter::moves == 1);
+    }
+
+    SUBCASE("Setting a field moves it into the PropertyGroup without copies")
+    {
+        PropertyGroup<MoveCounter> group;
+        MoveCounter::copies = 0;
+        MoveCounter::moves = 0;
+
+        group.set<0>(MoveCounter());
+        REQUIRE(MoveCounter::copies == 0);
+        REQUIRE(MoveCounter::moves == 1);
+    }
+
     SUBCASE("move constructed property maintains connections")
     {
         int countVoid = 0;
@@ -309,3 +429,683 @@ TEST_CASE("Moving")
         REQUIRE(*(movedProperty.get()) == 123);
     }
 }
+
+TEST_CASE("Replication")
+{
+    SUBCASE("The current value is published on the next evaluation")
+    {
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Property<int> source(42);
+        Property<int> target(0);
+
+        auto replication = replicate(source, target, evaluator);
+        REQUIRE(replication.isActive());
+        REQUIRE(target.get() == 0);
+
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(target.get() == 42);
+    }
+
+    SUBCASE("Intermediate values are coalesced")
+    {
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Property<int> source(0);
+        Property<int> target(0);
+        auto replication = replicate(source, target, evaluator);
+        evaluator->evaluateDeferredConnections();
+
+        std::vector<int> targetValues;
+        (void)target.valueChanged().connect([&targetValues](int value) { targetValues.push_back(value); });
+
+        for (int i = 1; i <= 100; ++i) {
+            source = i;
+        }
+        REQUIRE(evaluator->memoryUsage().liveSlots == 1);
+
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(targetValues == std::vector<int>{ 100 });
+
+        source = 7;
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(targetValues == std::vector<int>{ 100, 7 });
+    }
+
+    SUBCASE("Destroying the replication discards unpublished values")
+    {
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Property<int> source(1);
+        Property<int> target(0);
+        {
+            auto replication = replicate(source, target, evaluator);
+            source = 2;
+        }
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(target.get() == 0);
+
+        source = 3;
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(target.get() == 0);
+    }
+
+    SUBCASE("The replication stops when the target is destroyed")
+    {
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Property<int> source(1);
+        auto target = std::make_unique<Property<int>>(0);
+        auto replication = replicate(source, *target, evaluator);
+
+        target.reset();
+        REQUIRE_FALSE(replication.isActive());
+
+        source = 2;
+        evaluator->evaluateDeferredConnections();
+    }
+
+    SUBCASE("A Property can be replicated into another thread")
+    {
+        std::promise<std::shared_ptr<ThreadEventLoop>> loopPromise;
+        std::promise<std::string> received;
+        Property<std::string> target;
+
+        std::thread uiThread([&]() {
+            auto loop = ThreadEventLoop::create();
+            (void)target.valueChanged().connect([&](const std::string &value) {
+                if (value == "done") {
+                    received.set_value(value);
+                }
+            });
+            loopPromise.set_value(loop);
+            loop->exec();
+        });
+        auto loop = loopPromise.get_future().get();
+
+        Property<std::string> source("start");
+        {
+            auto replication = replicate(source, target, loop);
+            source = "intermediate";
+            source = "done";
+
+            REQUIRE(received.get_future().get() == "done");
+        }
+
+        loop->quit();
+        uiThread.join();
+        REQUIRE(target.get() == "done");
+    }
+}
+
+TEST_CASE("PropertyGroup")
+{
+    enum PersonField { Name, Age, Height };
+    using Person = PropertyGroup<std::string, int, double>;
+
+    SUBCASE("Setting a field emits changed with its bit")
+    {
+        Person person("Jane", 42, 1.7);
+        std::vector<Person::Mask> masks;
+        (void)person.changed().connect([&masks](Person::Mask mask) { masks.push_back(mask); });
+
+        person.set<Age>(43);
+        REQUIRE(person.get<Age>() == 43);
+        REQUIRE(masks == std::vector<Person::Mask>{ Person::fieldMask<Age>() });
+
+        // Assigning an equal value doesn't emit
+        person.set<Age>(43);
+        REQUIRE(masks.size() == 1);
+    }
+
+    SUBCASE("An update emits once with the combined mask")
+    {
+        Person person("Jane", 42, 1.7);
+        std::vector<Person::Mask> masks;
+        (void)person.changed().connect([&masks](Person::Mask mask) { masks.push_back(mask); });
+
+        person.update([&person]() {
+            person.set<Name>("John");
+            person.set<Height>(1.8);
+            person.update([&person]() { person.set<Age>(30); });
+        });
+        REQUIRE(masks == std::vector<Person::Mask>{ Person::fieldMask<Name>() | Person::fieldMask<Age>() | Person::fieldMask<Height>() });
+
+        // An update without changes doesn't emit
+        person.update([]() {});
+        REQUIRE(masks.size() == 1);
+    }
+
+    SUBCASE("An update that throws still emits the changes made so far")
+    {
+        Person person("Jane", 42, 1.7);
+        Person::Mask emitted = 0;
+        (void)person.changed().connect([&emitted](Person::Mask mask) { emitted = mask; });
+
+        REQUIRE_THROWS_AS(person.update([&person]() {
+            person.set<Age>(1);
+            throw std::runtime_error("error");
+        }),
+                          std::runtime_error);
+        REQUIRE(emitted == Person::fieldMask<Age>());
+    }
+
+    SUBCASE("A field can be used in a binding expression")
+    {
+        Person person("Jane", 42, 1.7);
+        auto nextAge = makeBoundProperty(person.node<Age>() + 1);
+        REQUIRE(nextAge.get() == 43);
+
+        int changes = 0;
+        (void)nextAge.valueChanged().connect([&changes]() { ++changes; });
+
+        person.set<Name>("John");
+        REQUIRE(changes == 0);
+
+        person.set<Age>(50);
+        REQUIRE(nextAge.get() == 51);
+        REQUIRE(changes == 1);
+    }
+
+    SUBCASE("A field can be the target of a Binding")
+    {
+        Property<int> birthYear(1990);
+        Person person;
+        person.bind<Age>(makeBinding(2024 - birthYear));
+        REQUIRE(person.hasBinding<Age>());
+        REQUIRE(person.get<Age>() == 34);
+        REQUIRE_THROWS_AS(person.set<Age>(1), ReadOnlyProperty);
+
+        birthYear = 2000;
+        REQUIRE(person.get<Age>() == 24);
+
+        person.unbind<Age>();
+        person.set<Age>(1);
+        REQUIRE(person.get<Age>() == 1);
+    }
+
+    SUBCASE("A suspended Binding of a field catches up when the field is read")
+    {
+        Property<int> birthYear(1990);
+        Person person;
+        auto binding = makeBinding(2024 - birthYear);
+        auto *bindingPtr = binding.get();
+        bindingPtr->setSuspendWhenUnobserved(true);
+        person.bind<Age>(std::move(binding));
+
+        birthYear = 2000;
+        REQUIRE(bindingPtr->isSuspended());
+        REQUIRE(person.get<Age>() == 24);
+        REQUIRE_FALSE(bindingPtr->isSuspended());
+    }
+
+    SUBCASE("A field can be bound to another field of the same PropertyGroup")
+    {
+        enum PairField { First, Second };
+        using Pair = PropertyGroup<int, int>;
+        Pair pair(1, 0);
+        pair.bind<Second>(makeBinding(pair.node<First>() + 1));
+        REQUIRE(pair.get<Second>() == 2);
+
+        std::vector<Pair::Mask> masks;
+        (void)pair.changed().connect([&masks](Pair::Mask mask) { masks.push_back(mask); });
+
+        // The change of the bound field is emitted once the emission for the first field finished
+        pair.set<First>(5);
+        REQUIRE(pair.get<Second>() == 6);
+        REQUIRE(masks == std::vector<Pair::Mask>{ Pair::fieldMask<First>(), Pair::fieldMask<Second>() });
+
+        // The PropertyGroup keeps working afterwards
+        pair.set<First>(7);
+        REQUIRE(pair.get<Second>() == 8);
+        REQUIRE(masks.size() == 4);
+    }
+
+    SUBCASE("Evaluating a node of a destroyed PropertyGroup throws")
+    {
+        auto person = std::make_unique<Person>("Jane", 42, 1.7);
+        auto node = person->node<Age>();
+        REQUIRE(node.evaluate() == 42);
+        person.reset();
+        REQUIRE_THROWS_AS(node.evaluate(), PropertyDestroyedError);
+    }
+}
+
+// Maps every key to one of a few hashes, so keys collide on all levels of a PersistentMap.
+struct CollidingHash {
+    std::size_t operator()(int key) const noexcept
+    {
+        return static_cast<std::size_t>(key % 3);
+    }
+};
+
+TEST_CASE("PersistentVector")
+{
+    SUBCASE("Behaves like a std::vector across all tree levels")
+    {
+        PersistentVector<int> vector;
+        std::vector<int> expected;
+        std::vector<PersistentVector<int>> versions;
+        for (int i = 0; i < 33000; ++i) {
+            vector = vector.push_back(i);
+            expected.push_back(i);
+            if (i % 1000 == 0) {
+                versions.push_back(vector);
+            }
+        }
+        REQUIRE(vector.size() == expected.size());
+        REQUIRE(std::vector<int>(vector.begin(), vector.end()) == expected);
+        REQUIRE(vector == PersistentVector<int>(expected.begin(), expected.end()));
+
+        for (std::size_t i = 0; i < expected.size(); i += 97) {
+            vector = vector.set(i, -1);
+            expected[i] = -1;
+        }
+        REQUIRE(std::vector<int>(vector.begin(), vector.end()) == expected);
+
+        while (!vector.empty()) {
+            vector = vector.pop_back();
+            expected.pop_back();
+            if (expected.size() % 1031 == 0) {
+                REQUIRE(std::vector<int>(vector.begin(), vector.end()) == expected);
+            }
+        }
+
+        // Earlier versions are not affected by modifications of later ones
+        for (std::size_t v = 1; v < versions.size(); ++v) {
+            REQUIRE(versions[v].size() == v * 1000 + 1);
+            REQUIRE(versions[v].back() == int(v * 1000));
+            REQUIRE(versions[v][97] == 97);
+        }
+    }
+
+    SUBCASE("Out of range access throws")
+    {
+        PersistentVector<int> vector{ 1, 2, 3 };
+        REQUIRE_THROWS_AS(vector.at(3), std::out_of_range);
+        REQUIRE_THROWS_AS(vector.set(3, 0), std::out_of_range);
+        REQUIRE_THROWS_AS(PersistentVector<int>().pop_back(), std::out_of_range);
+    }
+
+    SUBCASE("Setting an equal value returns the vector itself")
+    {
+        PersistentVector<std::string> vector{ "a", "b" };
+        REQUIRE(vector.set(1, "b") == vector);
+        REQUIRE(vector.set(1, "c") != vector);
+        REQUIRE(vector.set(1, "c").at(1) == "c");
+        REQUIRE(vector.at(1) == "b");
+    }
+}
+
+TEST_CASE("PersistentMap")
+{
+    SUBCASE("Behaves like a std::map")
+    {
+        PersistentMap<int, int> map;
+        std::map<int, int> expected;
+        for (int i = 0; i < 5000; ++i) {
+            const int key = (i * 7919) % 3001;
+            map = map.set(key, i);
+            expected[key] = i;
+        }
+        for (int i = 0; i < 3001; i += 3) {
+            map = map.erase(i);
+            expected.erase(i);
+        }
+
+        REQUIRE(map.size() == expected.size());
+        for (const auto &[key, value] : expected) {
+            REQUIRE(map.at(key) == value);
+        }
+        REQUIRE_FALSE(map.contains(3));
+        REQUIRE(map.find(3) == nullptr);
+        REQUIRE_THROWS_AS(map.at(3), std::out_of_range);
+
+        std::map<int, int> iterated(map.begin(), map.end());
+        REQUIRE(iterated == expected);
+    }
+
+    SUBCASE("Colliding hashes")
+    {
+        PersistentMap<int, std::string, CollidingHash> map;
+        for (int i = 0; i < 30; ++i) {
+            map = map.set(i, std::to_string(i));
+        }
+        REQUIRE(map.size() == 30);
+        REQUIRE(map.at(29) == "29");
+
+        for (int i = 0; i < 30; i += 2) {
+            map = map.erase(i);
+        }
+        REQUIRE(map.size() == 15);
+        REQUIRE_FALSE(map.contains(4));
+        REQUIRE(map.at(5) == "5");
+        REQUIRE(std::distance(map.begin(), map.end()) == 15);
+    }
+
+    SUBCASE("Equality doesn't depend on the order of insertion")
+    {
+        PersistentMap<int, int, CollidingHash> ascending;
+        PersistentMap<int, int, CollidingHash> descending;
+        for (int i = 0; i < 100; ++i) {
+            ascending = ascending.set(i, i);
+            descending = descending.set(99 - i, 99 - i);
+        }
+        REQUIRE(ascending == descending);
+        REQUIRE(ascending.set(50, 0) != descending);
+
+        // Removing entries restores the canonical structure
+        auto reduced = ascending.set(1000, 1).erase(1000);
+        REQUIRE(reduced == descending);
+        REQUIRE(PersistentMap<int, int>{ { 1, 1 } }.erase(1) == PersistentMap<int, int>());
+    }
+
+    SUBCASE("Unchanged maps are returned as they are")
+    {
+        PersistentMap<std::string, int> map{ { "a", 1 }, { "b", 2 } };
+        const auto same = map.set("a", 1).erase("c");
+        REQUIRE(same == map);
+        REQUIRE(same.size() == 2);
+    }
+}
+
+TEST_CASE("Persistent containers in Properties")
+{
+    PersistentMap<int, std::string> initial;
+    for (int i = 0; i < 1000; ++i) {
+        initial = initial.set(i, std::to_string(i));
+    }
+    Property<PersistentMap<int, std::string>> property(initial);
+
+    // Keeping the old and new values only copies their roots
+    std::vector<std::pair<PersistentMap<int, std::string>, PersistentMap<int, std::string>>> changes;
+    int changed = 0;
+    (void)property.valueAboutToChange().connect([&changes](const auto &oldValue, const auto &newValue) {
+        changes.emplace_back(oldValue, newValue);
+    });
+    (void)property.valueChanged().connect([&changed](const auto &) { ++changed; });
+
+    // A snapshot shares the structure of the value, so modifying the Property doesn't affect it
+    const auto snapshot = property.get();
+
+    property = property.get().set(7, "7");
+    REQUIRE(changed == 0);
+
+    property = property.get().set(7, "seven");
+    REQUIRE(changes.size() == 1);
+    REQUIRE(changes[0].first.at(7) == "7");
+    REQUIRE(changes[0].second.at(7) == "seven");
+    REQUIRE(changed == 1);
+    REQUIRE(snapshot.at(7) == "7");
+    REQUIRE(property.get().at(7) == "seven");
+
+    // Undo by assigning the snapshot
+    property = snapshot;
+    REQUIRE(changed == 2);
+    REQUIRE(property.get() == initial);
+}
+
+TEST_CASE("ChangeFeed")
+{
+    std::vector<std::vector<std::byte>> flushes;
+    ChangeFeed feed([&flushes](const std::byte *data, std::size_t size) { flushes.emplace_back(data, data + size); });
+
+    auto records = [](const std::vector<std::byte> &buffer) {
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> result;
+        const auto consumed = ChangeFeed::parse(buffer.data(), buffer.size(), [&result](const ChangeRecord &record) {
+            result.emplace_back(record.propertyId, record.version);
+        });
+        REQUIRE(consumed == buffer.size());
+        return result;
+    };
+
+    Property<int> width(10);
+    Property<std::string> title("untitled");
+    feed.track(1, width);
+    feed.track(300, title);
+    REQUIRE(feed.trackedCount() == 2);
+    REQUIRE_THROWS_AS(feed.track(1, title), std::invalid_argument);
+
+    SUBCASE("The initial state is flushed once")
+    {
+        REQUIRE(feed.flush() == 2);
+        REQUIRE(flushes.size() == 1);
+
+        std::vector<std::string> values;
+        ChangeFeed::parse(flushes[0].data(), flushes[0].size(), [&values](const ChangeRecord &record) {
+            if (record.propertyId == 1) {
+                values.push_back(std::to_string(ChangeFeedSerializer<int>::deserialize(record.data, record.size)));
+            } else {
+                values.push_back(ChangeFeedSerializer<std::string>::deserialize(record.data, record.size));
+            }
+        });
+        REQUIRE(values == std::vector<std::string>{ "10", "untitled" });
+
+        // Nothing changed, so the sink isn't called
+        REQUIRE(feed.flush() == 0);
+        REQUIRE(flushes.size() == 1);
+    }
+
+    SUBCASE("Repeated changes are coalesced")
+    {
+        feed.flush();
+        title = "a";
+        width = 11;
+        title = "b";
+        title = "c";
+        REQUIRE(feed.pendingCount() == 2);
+
+        REQUIRE(feed.flush() == 2);
+        REQUIRE(records(flushes[1]) == std::vector<std::pair<std::uint32_t, std::uint64_t>>{ { 300, 3 }, { 1, 1 } });
+
+        std::string latest;
+        ChangeFeed::parse(flushes[1].data(), flushes[1].size(), [&latest](const ChangeRecord &record) {
+            if (record.propertyId == 300) {
+                latest = ChangeFeedSerializer<std::string>::deserialize(record.data, record.size);
+            }
+        });
+        REQUIRE(latest == "c");
+    }
+
+    SUBCASE("Untracked Properties are not flushed")
+    {
+        REQUIRE(feed.untrack(1));
+        REQUIRE_FALSE(feed.untrack(1));
+        width = 12;
+        REQUIRE(feed.flush() == 1);
+        REQUIRE(records(flushes[0]) == std::vector<std::pair<std::uint32_t, std::uint64_t>>{ { 300, 0 } });
+    }
+
+    SUBCASE("Changes stay pending if the sink throws")
+    {
+        ChangeFeed failing([](const std::byte *, std::size_t) { throw std::runtime_error("disk full"); });
+        failing.track(1, width);
+        REQUIRE_THROWS_AS(failing.flush(), std::runtime_error);
+        REQUIRE(failing.pendingCount() == 1);
+    }
+
+    SUBCASE("Incomplete records are left for the next read")
+    {
+        feed.flush();
+        const auto &buffer = flushes[0];
+        std::size_t recordCount = 0;
+        const auto consumed = ChangeFeed::parse(buffer.data(), buffer.size() - 1, [&recordCount](const ChangeRecord &) { ++recordCount; });
+        REQUIRE(recordCount == 1);
+        REQUIRE(consumed < buffer.size() - 1);
+        REQUIRE(ChangeFeed::parse(buffer.data() + consumed, buffer.size() - consumed, [&recordCount](const ChangeRecord &) { ++recordCount; }) == buffer.size() - consumed);
+        REQUIRE(recordCount == 2);
+    }
+
+    SUBCASE("Streams can be used as sinks")
+    {
+        std::ostringstream stream;
+        ChangeFeed streamed(ChangeFeed::streamSink(stream));
+        streamed.track(7, width);
+        streamed.flush();
+        width = 20;
+        streamed.flush();
+
+        const std::string written = stream.str();
+        std::vector<int> values;
+        ChangeFeed::parse(reinterpret_cast<const std::byte *>(written.data()), written.size(), [&values](const ChangeRecord &record) {
+            values.push_back(ChangeFeedSerializer<int>::deserialize(record.data, record.size));
+        });
+        REQUIRE(values == std::vector<int>{ 10, 20 });
+    }
+}
+
+#if defined(__linux__)
+namespace {
+
+class TemporaryDirectory
+{
+public:
+    TemporaryDirectory()
+    {
+        char pathTemplate[] = "/tmp/kdbindings-XXXXXX";
+        path = ::mkdtemp(pathTemplate);
+    }
+
+    ~TemporaryDirectory()
+    {
+        for (const auto &file : files) {
+            std::remove(file.c_str());
+        }
+        ::rmdir(path.c_str());
+    }
+
+    std::string filePath(const std::string &name)
+    {
+        files.push_back(path + "/" + name);
+        return files.back();
+    }
+
+    std::string path;
+    std::vector<std::string> files;
+};
+
+void writeFile(const std::string &path, const void *data, std::size_t size)
+{
+    FILE *file = std::fopen(path.c_str(), "wb");
+    REQUIRE(file);
+    REQUIRE(std::fwrite(data, 1, size, file) == size);
+    std::fclose(file);
+}
+
+} // namespace
+
+TEST_CASE("MappedFileProperty")
+{
+    TemporaryDirectory directory;
+    const std::string path = directory.filePath("value");
+
+    SUBCASE("Reads a trivially copyable value and reloads it when the file is rewritten")
+    {
+        const std::int32_t initial = 42;
+        writeFile(path, &initial, sizeof(initial));
+
+        MappedFileProperty<std::int32_t> value(path);
+        REQUIRE(value.get() == 42);
+        REQUIRE(value.fileDescriptor() >= 0);
+        REQUIRE_FALSE(value.processEvents());
+
+        auto doubled = makeBoundProperty([](std::int32_t v) { return v * 2; }, value.property());
+        std::vector<std::int32_t> changes;
+        (void)value.valueChanged().connect([&changes](std::int32_t newValue) { changes.push_back(newValue); });
+
+        const std::int32_t updated = 7;
+        writeFile(path, &updated, sizeof(updated));
+        REQUIRE(value.processEvents());
+        REQUIRE(value.get() == 7);
+        REQUIRE(doubled.get() == 14);
+        REQUIRE(changes == std::vector<std::int32_t>{ 7 });
+    }
+
+    SUBCASE("Detects files that are atomically replaced")
+    {
+        const std::int32_t initial = 1;
+        writeFile(path, &initial, sizeof(initial));
+        MappedFileProperty<std::int32_t> value(path);
+
+        for (std::int32_t i = 2; i < 5; ++i) {
+            const std::string temporary = directory.filePath("value.tmp");
+            writeFile(temporary, &i, sizeof(i));
+            REQUIRE(std::rename(temporary.c_str(), path.c_str()) == 0);
+            REQUIRE(value.processEvents());
+            REQUIRE(value.get() == i);
+        }
+    }
+
+    SUBCASE("Changes of other files in the directory are ignored")
+    {
+        const std::int32_t initial = 1;
+        writeFile(path, &initial, sizeof(initial));
+        MappedFileProperty<std::int32_t> value(path);
+
+        writeFile(directory.filePath("other"), &initial, sizeof(initial));
+        REQUIRE_FALSE(value.processEvents());
+    }
+
+    SUBCASE("Reads types that aren't default constructible")
+    {
+        struct Point {
+            Point(std::int32_t xValue, std::int32_t yValue)
+                : x(xValue)
+                , y(yValue)
+            {
+            }
+            std::int32_t x;
+            std::int32_t y;
+            bool operator==(const Point &other) const { return x == other.x && y == other.y; }
+        };
+        static_assert(!std::is_default_constructible_v<Point>);
+
+        const Point initial(3, 4);
+        writeFile(path, &initial, sizeof(initial));
+        MappedFileProperty<Point> value(path);
+        REQUIRE(value.get() == Point(3, 4));
+
+        const Point updated(5, 6);
+        writeFile(path, &updated, sizeof(updated));
+        REQUIRE(value.processEvents());
+        REQUIRE(value.get() == Point(5, 6));
+    }
+
+    SUBCASE("Keeps the previous value if the file becomes too small")
+    {
+        const std::int64_t initial = 5;
+        writeFile(path, &initial, sizeof(initial));
+        MappedFileProperty<std::int64_t> value(path);
+
+        const std::int8_t tooSmall = 1;
+        writeFile(path, &tooSmall, sizeof(tooSmall));
+        REQUIRE_FALSE(value.processEvents());
+        REQUIRE(value.get() == 5);
+    }
+
+    SUBCASE("MappedBuffer refers to the contents without copying them")
+    {
+        const std::string first = "first contents";
+        writeFile(path, first.data(), first.size());
+
+        MappedFileProperty<MappedBuffer> file(path);
+        const MappedBuffer firstBuffer = file.get();
+        REQUIRE(std::string(reinterpret_cast<const char *>(firstBuffer.data()), firstBuffer.size()) == first);
+
+        const std::string second = "second";
+        const std::string temporary = directory.filePath("value.tmp");
+        writeFile(temporary, second.data(), second.size());
+        REQUIRE(std::rename(temporary.c_str(), path.c_str()) == 0);
+        REQUIRE(file.processEvents());
+
+        REQUIRE(std::string(reinterpret_cast<const char *>(file.get().data()), file.get().size()) == second);
+        // The previous mapping stays valid as long as it is referenced
+        REQUIRE(std::string(reinterpret_cast<const char *>(firstBuffer.data()), firstBuffer.size()) == first);
+    }
+
+    SUBCASE("Throws if the file can't be mapped")
+    {
+        REQUIRE_THROWS_AS(MappedFileProperty<int>{ directory.path + "/missing" }, std::system_error);
+
+        const std::int8_t tooSmall = 1;
+        writeFile(path, &tooSmall, sizeof(tooSmall));
+        REQUIRE_THROWS_AS(MappedFileProperty<std::int64_t>{ path }, std::length_error);
+    }
+}
+#endif
@@ -12,10 +12,24 @@
 #include "kdbindings/utils.h"
 #include <kdbindings/signal.h>
 #include <kdbindings/connection_evaluator.h>
-
+#include <kdbindings/homogeneous_signal.h>
+#include <kdbindings/intrusive_signal.h>
+#include <kdbindings/parallel_emission.h>
+#include <kdbindings/queued_connection.h>
+#include <kdbindings/static_connections.h>
+#include <kdbindings/timed_emission.h>
+#include <kdbindings/thread_event_loop.h>
+#include <kdbindings/thread_pool.h>
+#include <kdbindings/timer_scheduler.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
@@ -544,6 +558,25 @@ TEST_CASE("ConnectionEvaluator")
         REQUIRE(anotherCalled);
     }
 
+    SUBCASE("Deferred connection disconnects itself once the evaluator is destroyed")
+    {
+        Signal<int> signal;
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        int val = 0;
+
+        auto handle = signal.connectDeferred(evaluator, [&val](int value) { val += value; });
+        (void)signal.connect([&val](int value) { val += value * 10; });
+
+        evaluator.reset();
+        REQUIRE_NOTHROW(signal.emit(1));
+        REQUIRE_FALSE(handle.isActive());
+        REQUIRE(signal.connectionCount() == 1);
+
+        // The Signal keeps working afterwards
+        REQUIRE_NOTHROW(signal.emit(1));
+        REQUIRE(val == 20);
+    }
+
     SUBCASE("Subclassing ConnectionEvaluator")
     {
         class MyConnectionEvaluator : public ConnectionEvaluator
@@ -578,6 +611,94 @@ TEST_CASE("ConnectionEvaluator")
     }
 }
 
+TEST_CASE("ThreadEventLoop")
+{
+    SUBCASE("A thread without an event loop can not receive queued connections")
+    {
+        Signal<int> signal;
+        REQUIRE(ThreadEventLoop::current() == nullptr);
+        REQUIRE_THROWS_AS((void)connectQueued(signal, [](int) {}), std::runtime_error);
+    }
+
+    SUBCASE("A thread can only register one event loop")
+    {
+        auto loop = ThreadEventLoop::create();
+        REQUIRE(ThreadEventLoop::current() == loop);
+        REQUIRE(ThreadEventLoop::forThread(std::this_thread::get_id()) == loop);
+        REQUIRE_THROWS_AS(ThreadEventLoop::create(), std::logic_error);
+    }
+
+    SUBCASE("An event loop is unregistered when it is destroyed")
+    {
+        {
+            auto loop = ThreadEventLoop::create();
+        }
+        REQUIRE(ThreadEventLoop::current() == nullptr);
+        REQUIRE(ThreadEventLoop::forThread(std::this_thread::get_id()) == nullptr);
+    }
+
+    SUBCASE("A queued connection to the connecting thread is evaluated by its event loop")
+    {
+        auto loop = ThreadEventLoop::create();
+        Signal<int> signal;
+        int val = 0;
+        (void)connectQueued(signal, [&val](int value) { val += value; });
+
+        signal.emit(4);
+        REQUIRE(val == 0);
+
+        loop->evaluateDeferredConnections();
+        REQUIRE(val == 4);
+    }
+
+    SUBCASE("A queued connection evaluates the slot in the target thread")
+    {
+        std::promise<std::shared_ptr<ThreadEventLoop>> loopPromise;
+        std::thread worker([&loopPromise]() {
+            auto loop = ThreadEventLoop::create();
+            loopPromise.set_value(loop);
+            loop->exec();
+        });
+        auto loop = loopPromise.get_future().get();
+
+        Signal<int> signal;
+        std::promise<std::thread::id> slotThread;
+        int val = 0;
+        (void)connectQueued(
+                signal, [&](int value) {
+                    val = value;
+                    slotThread.set_value(std::this_thread::get_id());
+                },
+                worker.get_id());
+
+        signal.emit(42);
+        REQUIRE(slotThread.get_future().get() == worker.get_id());
+        REQUIRE(val == 42);
+
+        loop->quit();
+        worker.join();
+    }
+
+    SUBCASE("A queued connection disconnects itself once the target thread finished")
+    {
+        std::thread::id workerId;
+        Signal<int> signal;
+        ConnectionHandle handle;
+        std::thread worker([&]() {
+            auto loop = ThreadEventLoop::create();
+            workerId = std::this_thread::get_id();
+            handle = connectQueued(signal, [](int) {});
+        });
+        worker.join();
+
+        REQUIRE(ThreadEventLoop::forThread(workerId) == nullptr);
+        REQUIRE(handle.isActive());
+        REQUIRE_NOTHROW(signal.emit(1));
+        REQUIRE_FALSE(handle.isActive());
+        REQUIRE(signal.connectionCount() == 0);
+    }
+}
+
 TEST_CASE("Moving")
 {
     SUBCASE("a move constructed signal keeps the connections")
@@ -697,6 +818,134 @@ TEST_CASE("Connection blocking")
     }
 }
 
+TEST_CASE("Signal connection count")
+{
+    Signal<int> signal;
+    REQUIRE(signal.connectionCount() == 0);
+
+    auto handle = signal.connect([](int) {});
+    (void)signal.connect([](int) {});
+    REQUIRE(signal.connectionCount() == 2);
+
+    handle.block(true);
+    REQUIRE(signal.connectionCount() == 2);
+
+    handle.disconnect();
+    REQUIRE(signal.connectionCount() == 1);
+
+    signal.disconnectAll();
+    REQUIRE(signal.connectionCount() == 0);
+}
+
+TEST_CASE("Signal blocking")
+{
+    SUBCASE("blocking a Signal blocks all of its slots")
+    {
+        int count = 0;
+        Signal<int> signal;
+        (void)signal.connect([&count](int) { ++count; });
+        (void)signal.connect([&count](int) { ++count; });
+
+        REQUIRE_FALSE(signal.isBlocked());
+        REQUIRE_FALSE(signal.blockAll(true));
+        REQUIRE(signal.isBlocked());
+
+        signal.emit(1);
+        REQUIRE(count == 0);
+
+        REQUIRE(signal.blockAll(false));
+        signal.emit(1);
+        REQUIRE(count == 2);
+    }
+
+    SUBCASE("blocking a Signal does not change the blocked state of its connections")
+    {
+        int count = 0;
+        Signal<> signal;
+        const auto handle = signal.connect([&count]() { ++count; });
+        (void)signal.connect([&count]() { count += 10; });
+        signal.blockConnection(handle, true);
+
+        signal.blockAll(true);
+        REQUIRE(signal.isConnectionBlocked(handle));
+        signal.blockAll(false);
+
+        REQUIRE(signal.isConnectionBlocked(handle));
+        signal.emit();
+        REQUIRE(count == 10);
+    }
+
+    SUBCASE("a Signal can be blocked before any slot is connected")
+    {
+        int count = 0;
+        Signal<> signal;
+        signal.blockAll(true);
+
+        (void)signal.connect([&count]() { ++count; });
+        signal.emit();
+        REQUIRE(count == 0);
+    }
+
+    SUBCASE("a blocked Signal stays blocked after disconnecting all slots")
+    {
+        int count = 0;
+        Signal<> signal;
+        (void)signal.connect([&count]() { ++count; });
+        signal.blockAll(true);
+
+        signal.disconnectAll();
+        REQUIRE(signal.isBlocked());
+
+        (void)signal.connect([&count]() { ++count; });
+        signal.emit();
+        REQUIRE(count == 0);
+    }
+
+    SUBCASE("a blocked Signal doesn't enqueue deferred invocations")
+    {
+        int count = 0;
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Signal<int> signal;
+        (void)signal.connectDeferred(evaluator, [&count](int) { ++count; });
+
+        signal.blockAll(true);
+        signal.emit(1);
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(count == 0);
+    }
+
+    SUBCASE("can block a Signal with a SignalBlocker")
+    {
+        int count = 0;
+        Signal<> signal;
+        (void)signal.connect([&count]() { ++count; });
+
+        {
+            SignalBlocker blocker(signal);
+            REQUIRE(signal.isBlocked());
+            signal.emit();
+            REQUIRE(count == 0);
+        }
+
+        REQUIRE_FALSE(signal.isBlocked());
+        signal.emit();
+        REQUIRE(count == 1);
+    }
+
+    SUBCASE("SignalBlocker leaves already blocked Signals blocked")
+    {
+        Signal<> signal;
+        signal.blockAll(true);
+
+        {
+            SignalBlocker blocker(signal);
+            REQUIRE(signal.isBlocked());
+        }
+
+        REQUIRE(signal.isBlocked());
+    }
+}
+
 TEST_CASE("ConnectionHandle")
 {
     SUBCASE("A default constructed ConnectionHandle is not active")
@@ -894,3 +1143,713 @@ TEST_CASE("ScopedConnection")
         REQUIRE(called);
     }
 }
+
+TEST_CASE("TimerScheduler")
+{
+    using namespace std::chrono_literals;
+
+    // A manually advanced clock, so the tests don't need to wait.
+    auto now = std::chrono::steady_clock::time_point{};
+    auto clock = [&now]() { return now; };
+
+    SUBCASE("A timer fires once its delay has passed")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        int fired = 0;
+        auto handle = scheduler.schedule(10ms, [&fired]() { ++fired; });
+        REQUIRE(handle.isActive());
+        REQUIRE(scheduler.pendingTimers() == 1);
+
+        now += 9ms;
+        REQUIRE(scheduler.processTimers() == 0);
+        REQUIRE(fired == 0);
+
+        now += 1ms;
+        REQUIRE(scheduler.processTimers() == 1);
+        REQUIRE(fired == 1);
+        REQUIRE_FALSE(handle.isActive());
+        REQUIRE(scheduler.pendingTimers() == 0);
+    }
+
+    SUBCASE("Delays are rounded up to the resolution")
+    {
+        TimerScheduler scheduler(10ms, clock);
+        int fired = 0;
+        (void)scheduler.schedule(11ms, [&fired]() { ++fired; });
+
+        now += 19ms;
+        scheduler.processTimers();
+        REQUIRE(fired == 0);
+
+        now += 1ms;
+        scheduler.processTimers();
+        REQUIRE(fired == 1);
+    }
+
+    SUBCASE("A cancelled timer doesn't fire")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        int fired = 0;
+        auto handle = scheduler.schedule(5ms, [&fired]() { ++fired; });
+        handle.cancel();
+        REQUIRE_FALSE(handle.isActive());
+
+        now += 10ms;
+        REQUIRE(scheduler.processTimers() == 0);
+        REQUIRE(fired == 0);
+    }
+
+    SUBCASE("Timers fire in every level of the wheel")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        std::vector<int> fired;
+        for (int delay : { 1, 255, 256, 300, 65535, 65536, 70000, 16777216, 20000000 }) {
+            (void)scheduler.schedule(std::chrono::milliseconds(delay), [&fired, delay]() { fired.push_back(delay); });
+        }
+
+        for (int delay : { 1, 255, 256, 300, 65535, 65536, 70000, 16777216, 20000000 }) {
+            now = std::chrono::steady_clock::time_point{} + std::chrono::milliseconds(delay - 1);
+            scheduler.processTimers();
+            REQUIRE(fired.size() < 9);
+            REQUIRE((fired.empty() || fired.back() != delay));
+
+            now += 1ms;
+            scheduler.processTimers();
+            REQUIRE(fired.back() == delay);
+        }
+    }
+
+    SUBCASE("A periodic timer fires until it is cancelled")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        int fired = 0;
+        auto handle = scheduler.schedulePeriodic(10ms, [&fired]() { ++fired; });
+
+        for (int i = 0; i < 5; ++i) {
+            now += 10ms;
+            scheduler.processTimers();
+        }
+        REQUIRE(fired == 5);
+
+        handle.cancel();
+        now += 10ms;
+        scheduler.processTimers();
+        REQUIRE(fired == 5);
+    }
+
+    SUBCASE("A callback may reschedule itself without delay")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        int fired = 0;
+        std::function<void()> callback = [&]() {
+            ++fired;
+            (void)scheduler.schedule(0ms, callback);
+        };
+        (void)scheduler.schedule(0ms, callback);
+
+        REQUIRE(scheduler.processTimers() == 1);
+        REQUIRE(scheduler.processTimers() == 1);
+        REQUIRE(fired == 2);
+    }
+
+    SUBCASE("A million pending timers")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        constexpr int count = 1000000;
+        int fired = 0;
+        std::vector<TimerHandle> handles;
+        handles.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            handles.push_back(scheduler.schedule(std::chrono::milliseconds(1 + i % 5000), [&fired]() { ++fired; }));
+        }
+        REQUIRE(scheduler.pendingTimers() == count);
+
+        for (int i = 0; i < count; i += 2) {
+            handles[i].cancel();
+        }
+        REQUIRE(scheduler.pendingTimers() == count / 2);
+
+        now += 5000ms;
+        REQUIRE(scheduler.processTimers() == count / 2);
+        REQUIRE(fired == count / 2);
+        REQUIRE(scheduler.pendingTimers() == 0);
+    }
+
+    SUBCASE("Signals can be emitted after a delay and periodically")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        Signal<const std::string &> signal;
+        std::vector<std::string> values;
+        (void)signal.connect([&values](const std::string &value) { values.push_back(value); });
+
+        (void)emitAfter(signal, scheduler, 5ms, "once");
+        auto periodic = emitPeriodically(signal, scheduler, 2ms, "tick");
+
+        for (int i = 0; i < 5; ++i) {
+            now += 1ms;
+            scheduler.processTimers();
+        }
+        periodic.cancel();
+        REQUIRE(values == std::vector<std::string>{ "tick", "tick", "once" });
+    }
+
+    SUBCASE("A delayed emission of a destroyed Signal is dropped")
+    {
+        TimerScheduler scheduler(1ms, clock);
+        {
+            Signal<int> signal;
+            (void)signal.connect([](int) { FAIL("The Signal no longer exists"); });
+            (void)emitAfter(signal, scheduler, 1ms, 1);
+        }
+        now += 1ms;
+        REQUIRE(scheduler.processTimers() == 1);
+    }
+
+    SUBCASE("Delayed connections queue their invocations in the evaluator after the delay")
+    {
+        auto scheduler = std::make_shared<TimerScheduler>(1ms, clock);
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Signal<int> signal;
+        std::vector<int> values;
+        auto handle = connectDelayed(signal, evaluator, scheduler, 10ms, [&values](int value) { values.push_back(value); });
+
+        signal.emit(1);
+        now += 5ms;
+        signal.emit(2);
+
+        now += 5ms;
+        scheduler->processTimers();
+        REQUIRE(values.empty());
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(values == std::vector<int>{ 1 });
+
+        // Disconnecting drops the pending timer of the second emission
+        handle.disconnect();
+        now += 5ms;
+        scheduler->processTimers();
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(values == std::vector<int>{ 1 });
+    }
+
+    SUBCASE("Disconnecting a delayed connection removes queued invocations")
+    {
+        auto scheduler = std::make_shared<TimerScheduler>(1ms, clock);
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Signal<int> signal;
+        int fired = 0;
+        auto handle = connectDelayed(signal, evaluator, scheduler, 1ms, [&fired](int) { ++fired; });
+
+        signal.emit(1);
+        now += 1ms;
+        scheduler->processTimers();
+        handle.disconnect();
+        evaluator->evaluateDeferredConnections();
+        REQUIRE(fired == 0);
+    }
+
+    SUBCASE("A delayed connection disconnects itself once the TimerScheduler is destroyed")
+    {
+        auto scheduler = std::make_shared<TimerScheduler>(1ms, clock);
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Signal<int> signal;
+        int fired = 0;
+        auto handle = connectDelayed(signal, evaluator, scheduler, 1ms, [&fired](int) { ++fired; });
+        (void)signal.connect([&fired](int) { fired += 10; });
+
+        scheduler.reset();
+        REQUIRE_NOTHROW(signal.emit(1));
+        REQUIRE_FALSE(handle.isActive());
+
+        // The Signal keeps working afterwards
+        REQUIRE_NOTHROW(signal.emit(1));
+        REQUIRE(fired == 20);
+    }
+
+    SUBCASE("A TimerScheduler requires a positive resolution")
+    {
+        REQUIRE_THROWS_AS(TimerScheduler(0ms, clock), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Parallel emission")
+{
+    ThreadPool pool(3);
+
+    SUBCASE("Calls every slot exactly once and returns when all are done")
+    {
+        Signal<const std::string &> signal;
+        std::vector<std::atomic<int>> calls(64);
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+        std::atomic<int> wrongValues{ 0 };
+        std::vector<ConnectionHandle> handles;
+        for (auto &count : calls) {
+            handles.push_back(signal.connect([&count, &mutex, &threads, &wrongValues](const std::string &value) {
+                // doctest assertions are not thread safe, so check the value afterwards
+                if (value != "value") {
+                    ++wrongValues;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++count;
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            }));
+        }
+
+        emitParallel(signal, pool, "value");
+
+        for (const auto &count : calls) {
+            REQUIRE(count == 1);
+        }
+        REQUIRE(wrongValues == 0);
+        REQUIRE(threads.size() > 1);
+    }
+
+    SUBCASE("Skips blocked connections and blocked Signals")
+    {
+        Signal<int> signal;
+        std::atomic<int> sum{ 0 };
+        auto handle = signal.connect([&sum](int value) { sum += value; });
+        (void)signal.connect([&sum](int value) { sum += 10 * value; });
+
+        handle.block(true);
+        emitParallel(signal, pool, 1);
+        REQUIRE(sum == 10);
+
+        SignalBlocker blocker(signal);
+        emitParallel(signal, pool, 1);
+        REQUIRE(sum == 10);
+    }
+
+    SUBCASE("Slots can disconnect themselves")
+    {
+        Signal<int> signal;
+        std::atomic<int> calls{ 0 };
+        for (int i = 0; i < 32; ++i) {
+            (void)signal.connectReflective([&calls](ConnectionHandle &self, int) {
+                ++calls;
+                self.disconnect();
+            });
+        }
+
+        emitParallel(signal, pool, 1);
+        REQUIRE(calls == 32);
+        REQUIRE(signal.connectionCount() == 0);
+
+        emitParallel(signal, pool, 1);
+        REQUIRE(calls == 32);
+    }
+
+    SUBCASE("Rethrows the first exception after all slots were called")
+    {
+        Signal<int> signal;
+        std::atomic<int> calls{ 0 };
+        for (int i = 0; i < 16; ++i) {
+            (void)signal.connect([&calls, i](int) {
+                ++calls;
+                if (i == 3) {
+                    throw std::invalid_argument("slot failed");
+                }
+            });
+        }
+
+        REQUIRE_THROWS_AS(emitParallel(signal, pool, 1), std::invalid_argument);
+        REQUIRE(calls == 16);
+
+        // The Signal is no longer considered to be emitting
+        REQUIRE_THROWS_AS(emitParallel(signal, pool, 1), std::invalid_argument);
+        REQUIRE(calls == 32);
+    }
+
+    SUBCASE("Works without worker threads")
+    {
+        ThreadPool emptyPool(0);
+        Signal<int> signal;
+        int sum = 0;
+        (void)signal.connect([&sum](int value) { sum += value; });
+        (void)signal.connect([&sum](int value) { sum += value; });
+
+        emitParallel(signal, emptyPool, 2);
+        REQUIRE(sum == 4);
+    }
+}
+
+class Sensor
+{
+public:
+    Signal<int> measured;
+    Signal<std::string> renamed;
+};
+
+class Display
+{
+public:
+    void show(int value)
+    {
+        calls.push_back("show " + std::to_string(value));
+    }
+
+    void setTitle(const std::string &title)
+    {
+        calls.push_back("title " + title);
+    }
+
+    std::vector<std::string> calls;
+};
+
+class Logger
+{
+public:
+    void log(int value) const
+    {
+        total += value;
+    }
+
+    mutable int total = 0;
+};
+
+TEST_CASE("Static connections")
+{
+    using Wiring = StaticConnectionTable<
+            StaticConnection<&Sensor::measured, &Display::show>,
+            StaticConnection<&Sensor::measured, &Logger::log>,
+            StaticConnection<&Sensor::renamed, &Display::setTitle>>;
+
+    static_assert(Wiring::connectionCount<&Sensor::measured>() == 2);
+    static_assert(Wiring::connectionCount<&Sensor::renamed>() == 1);
+
+    Sensor sensor;
+    Display display;
+    Logger logger;
+    // The components can be passed in any order
+    Wiring wiring(logger, sensor, display);
+    REQUIRE(&wiring.component<Display>() == &display);
+
+    SUBCASE("Emitting through the table calls the static connections of that Signal only")
+    {
+        wiring.emit<&Sensor::measured>(3);
+        wiring.emit<&Sensor::renamed>("Temperature");
+        REQUIRE(display.calls == std::vector<std::string>{ "show 3", "title Temperature" });
+        REQUIRE(logger.total == 3);
+    }
+
+    SUBCASE("Static connections are called before the dynamic ones")
+    {
+        (void)sensor.measured.connect([&display](int value) { display.calls.push_back("dynamic " + std::to_string(value)); });
+        wiring.emit<&Sensor::measured>(5);
+        REQUIRE(display.calls == std::vector<std::string>{ "show 5", "dynamic 5" });
+        REQUIRE(logger.total == 5);
+
+        // Emitting the Signal directly only calls the dynamic connections
+        sensor.measured.emit(6);
+        REQUIRE(display.calls == std::vector<std::string>{ "show 5", "dynamic 5", "dynamic 6" });
+        REQUIRE(logger.total == 5);
+    }
+
+    SUBCASE("Blocking the Signal blocks the static connections as well")
+    {
+        SignalBlocker blocker(sensor.measured);
+        wiring.emit<&Sensor::measured>(5);
+        REQUIRE(display.calls.empty());
+        REQUIRE(logger.total == 0);
+    }
+}
+
+// A slot type whose instances only differ in their state.
+struct Accumulator {
+    void operator()(int value)
+    {
+        *total += value * weight;
+    }
+
+    int *total;
+    int weight;
+};
+
+TEST_CASE("HomogeneousSignal")
+{
+    HomogeneousSignal<Accumulator, int> signal;
+    int total = 0;
+
+    auto one = signal.connect(Accumulator{ &total, 1 });
+    auto ten = signal.connect(Accumulator{ &total, 10 });
+    auto hundred = signal.connect(Accumulator{ &total, 100 });
+    REQUIRE(signal.connectionCount() == 3);
+    REQUIRE(one.belongsTo(signal));
+
+    signal.emit(2);
+    REQUIRE(total == 222);
+
+    SUBCASE("Blocked connections are skipped")
+    {
+        REQUIRE_FALSE(ten.block(true));
+        REQUIRE(signal.isConnectionBlocked(ten));
+        {
+            ConnectionBlocker blocker(one);
+            total = 0;
+            signal.emit(1);
+            REQUIRE(total == 100);
+        }
+        total = 0;
+        signal.emit(1);
+        REQUIRE(total == 101);
+
+        REQUIRE(signal.blockConnection(ten, false));
+        total = 0;
+        signal.emit(1);
+        REQUIRE(total == 111);
+    }
+
+    SUBCASE("Disconnected connections are no longer called")
+    {
+        ten.disconnect();
+        REQUIRE_FALSE(ten.isActive());
+        REQUIRE(one.isActive());
+        REQUIRE(hundred.isActive());
+        REQUIRE(signal.connectionCount() == 2);
+
+        total = 0;
+        signal.emit(1);
+        REQUIRE(total == 101);
+
+        // Handles of other connections stay valid after the array was reordered
+        hundred.block(true);
+        total = 0;
+        signal.emit(1);
+        REQUIRE(total == 1);
+        REQUIRE_THROWS_AS(signal.disconnect(ten), std::out_of_range);
+    }
+
+    SUBCASE("ScopedConnections disconnect when they go out of scope")
+    {
+        {
+            ScopedConnection scoped = signal.connect(Accumulator{ &total, 1000 });
+            total = 0;
+            signal.emit(1);
+            REQUIRE(total == 1111);
+        }
+        total = 0;
+        signal.emit(1);
+        REQUIRE(total == 111);
+    }
+
+    SUBCASE("The whole HomogeneousSignal can be blocked")
+    {
+        signal.blockAll(true);
+        total = 0;
+        signal.emit(1);
+        REQUIRE(total == 0);
+        REQUIRE(signal.blockAll(false));
+        REQUIRE_FALSE(signal.isBlocked());
+    }
+
+    SUBCASE("Destroying the HomogeneousSignal deactivates all handles")
+    {
+        {
+            HomogeneousSignal<Accumulator, int> temporary;
+            one = temporary.connect(Accumulator{ &total, 1 });
+            REQUIRE(one.isActive());
+        }
+        REQUIRE_FALSE(one.isActive());
+    }
+}
+
+// A slot that disconnects or blocks connections of the HomogeneousSignal that calls it.
+struct Manipulator {
+    void operator()()
+    {
+        ++*calls;
+        if (disconnect) {
+            disconnect->disconnect();
+        }
+        if (block) {
+            block->block(true);
+        }
+    }
+
+    int *calls;
+    ConnectionHandle *disconnect = nullptr;
+    ConnectionHandle *block = nullptr;
+};
+
+TEST_CASE("HomogeneousSignal changes during emission")
+{
+    HomogeneousSignal<Manipulator> signal;
+    int calls = 0;
+    ConnectionHandle first;
+    ConnectionHandle second;
+    ConnectionHandle third;
+
+    first = signal.connect(Manipulator{ &calls, &first, &second });
+    second = signal.connect(Manipulator{ &calls });
+    third = signal.connect(Manipulator{ &calls });
+
+    // All slots are still called during the emission that changed them
+    signal.emit();
+    REQUIRE(calls == 3);
+    REQUIRE_FALSE(first.isActive());
+    REQUIRE(second.isBlocked());
+    REQUIRE(signal.connectionCount() == 2);
+
+    calls = 0;
+    signal.emit();
+    REQUIRE(calls == 1);
+
+    second.block(false);
+    calls = 0;
+    signal.emit();
+    REQUIRE(calls == 2);
+}
+
+// A receiver that embeds the storage of its connection to an IntrusiveSignal.
+class Recorder
+{
+public:
+    void record(int value)
+    {
+        values.push_back(value);
+        if (onRecord) {
+            onRecord();
+        }
+    }
+
+    std::vector<int> values;
+    std::function<void()> onRecord;
+    SlotHook<int> hook;
+};
+
+void recordTwice(Recorder &recorder, int value)
+{
+    recorder.record(value);
+    recorder.record(value);
+}
+
+TEST_CASE("IntrusiveSignal")
+{
+    IntrusiveSignal<int> signal;
+    Recorder first;
+    Recorder second;
+
+    signal.connect<&Recorder::record>(first.hook, first);
+    signal.connect<&recordTwice>(second.hook, second);
+    REQUIRE(signal.connectionCount() == 2);
+    REQUIRE(first.hook.isConnected());
+    REQUIRE(first.hook.belongsTo(signal));
+
+    signal.emit(1);
+    REQUIRE(first.values == std::vector<int>{ 1 });
+    REQUIRE(second.values == std::vector<int>{ 1, 1 });
+
+    SUBCASE("Destroying the receiver disconnects it")
+    {
+        {
+            Recorder temporary;
+            signal.connect<&Recorder::record>(temporary.hook, temporary);
+            REQUIRE(signal.connectionCount() == 3);
+        }
+        REQUIRE(signal.connectionCount() == 2);
+        signal.emit(2);
+        REQUIRE(first.values == std::vector<int>{ 1, 2 });
+    }
+
+    SUBCASE("Hooks can be disconnected and blocked")
+    {
+        REQUIRE_FALSE(second.hook.block(true));
+        REQUIRE(second.hook.isBlocked());
+        signal.emit(2);
+        REQUIRE(second.values == std::vector<int>{ 1, 1 });
+
+        first.hook.disconnect();
+        REQUIRE_FALSE(first.hook.isConnected());
+        REQUIRE_THROWS_AS(first.hook.block(true), std::out_of_range);
+        REQUIRE_THROWS_AS(signal.disconnect(first.hook), std::out_of_range);
+
+        // Reconnecting unblocks the connection
+        signal.connect<&Recorder::record>(second.hook, second);
+        REQUIRE_FALSE(second.hook.isBlocked());
+        signal.emit(3);
+        REQUIRE(first.values == std::vector<int>{ 1, 2 });
+        REQUIRE(second.values == std::vector<int>{ 1, 1, 3 });
+    }
+
+    SUBCASE("Connecting a hook to another IntrusiveSignal moves the connection")
+    {
+        IntrusiveSignal<int> other;
+        other.connect<&Recorder::record>(first.hook, first);
+        REQUIRE(first.hook.belongsTo(other));
+        REQUIRE(signal.connectionCount() == 1);
+
+        signal.emit(2);
+        REQUIRE(first.values == std::vector<int>{ 1 });
+    }
+
+    SUBCASE("Hooks can be disconnected during emission")
+    {
+        Recorder third;
+        signal.connect<&Recorder::record>(third.hook, third);
+
+        // Disconnect the current and the next hook from within a slot
+        first.onRecord = [&]() {
+            first.hook.disconnect();
+            second.hook.disconnect();
+        };
+        signal.emit(2);
+        REQUIRE(first.values == std::vector<int>{ 1, 2 });
+        REQUIRE(second.values == std::vector<int>{ 1, 1 });
+        REQUIRE(third.values == std::vector<int>{ 2 });
+        REQUIRE(signal.connectionCount() == 1);
+    }
+
+    SUBCASE("Hooks that are connected during emission are called as well")
+    {
+        Recorder late;
+        second.onRecord = [&]() {
+            if (!late.hook.isConnected()) {
+                signal.connect<&Recorder::record>(late.hook, late);
+            }
+        };
+        signal.emit(2);
+        REQUIRE(late.values == std::vector<int>{ 2 });
+    }
+
+    SUBCASE("Nested emits throw")
+    {
+        first.onRecord = [&]() { signal.emit(2); };
+        REQUIRE_THROWS_AS(signal.emit(2), std::runtime_error);
+    }
+
+    SUBCASE("The whole IntrusiveSignal can be blocked")
+    {
+        REQUIRE_FALSE(signal.blockAll(true));
+        signal.emit(2);
+        REQUIRE(first.values == std::vector<int>{ 1 });
+        REQUIRE(signal.blockAll(false));
+    }
+
+    SUBCASE("Moving the IntrusiveSignal keeps the connections")
+    {
+        IntrusiveSignal<int> moved = std::move(signal);
+        REQUIRE(first.hook.belongsTo(moved));
+        REQUIRE(moved.connectionCount() == 2);
+        REQUIRE(signal.connectionCount() == 0);
+
+        moved.emit(2);
+        REQUIRE(first.values == std::vector<int>{ 1, 2 });
+
+        // The moved-from IntrusiveSignal can be reused
+        Recorder third;
+        signal.connect<&Recorder::record>(third.hook, third);
+        signal.emit(3);
+        REQUIRE(third.values == std::vector<int>{ 3 });
+    }
+
+    SUBCASE("Destroying the IntrusiveSignal disconnects all hooks")
+    {
+        Recorder outliving;
+        {
+            IntrusiveSignal<int> temporary;
+            temporary.connect<&Recorder::record>(outliving.hook, outliving);
+        }
+        REQUIRE_FALSE(outliving.hook.isConnected());
+    }
+}
@@ -0,0 +1,229 @@
+/*
+  This file is part of KDBindings.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <kdbindings/binding.h>
+#include <kdbindings/connection_evaluator.h>
+#include <kdbindings/genindex_array.h>
+#include <kdbindings/memory_usage.h>
+#include <kdbindings/property.h>
+#include <kdbindings/signal.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <doctest.h>
+
+// The expansion of TEST_CASE from doctest leads to a clazy warning.
+// As this issue originates from doctest, disable the warning.
+// clazy:excludeall=non-pod-global-static
+
+using namespace KDBindings;
+
+// Counts the bytes allocated by operator new in this test executable, including memory that
+// isn't reported by trackedMemoryUsage(), like the control blocks of std::shared_ptr.
+namespace {
+std::atomic<std::size_t> s_heapBytes{ 0 };
+constexpr std::size_t s_headerSize = alignof(std::max_align_t);
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    auto *block = static_cast<unsigned char *>(std::malloc(size + s_headerSize));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+    s_heapBytes += size;
+    return block + s_headerSize;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (!pointer) {
+        return;
+    }
+    auto *block = static_cast<unsigned char *>(pointer) - s_headerSize;
+    s_heapBytes -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+TEST_CASE("GenerationalIndexArray memory usage")
+{
+    SUBCASE("An empty array doesn't use any memory")
+    {
+        Private::GenerationalIndexArray<int> array;
+        const auto usage = array.memoryUsage();
+        REQUIRE(usage.totalBytes() == 0);
+        REQUIRE(usage.liveSlots == 0);
+    }
+
+    SUBCASE("Erased values are reported as dead slots")
+    {
+        Private::GenerationalIndexArray<int> array;
+        auto index = array.insert(1);
+        (void)array.insert(2);
+
+        auto usage = array.memoryUsage();
+        REQUIRE(usage.liveSlots == 2);
+        REQUIRE(usage.liveBytes > 0);
+
+        const auto totalBefore = usage.totalBytes();
+        array.erase(index);
+
+        usage = array.memoryUsage();
+        REQUIRE(usage.liveSlots == 1);
+        REQUIRE(usage.deadSlots >= 1);
+        REQUIRE_MESSAGE(usage.totalBytes() >= totalBefore, "Erasing a value doesn't release memory");
+    }
+}
+
+TEST_CASE("Signal memory usage")
+{
+    SUBCASE("An unconnected Signal only reports its own size")
+    {
+        Signal<int> signal;
+        const auto usage = signal.memoryUsage();
+        REQUIRE(usage.liveBytes == sizeof(Signal<int>));
+        REQUIRE(usage.deadBytes == 0);
+    }
+
+    SUBCASE("Disconnected slots are reported as dead memory")
+    {
+        Signal<int> signal;
+        std::vector<ConnectionHandle> handles;
+        for (int i = 0; i < 10; ++i) {
+            handles.emplace_back(signal.connect([](int) {}));
+        }
+
+        auto usage = signal.memoryUsage();
+        REQUIRE(usage.liveSlots == 10);
+        const auto liveBytes = usage.liveBytes;
+
+        for (auto &handle : handles) {
+            handle.disconnect();
+        }
+
+        usage = signal.memoryUsage();
+        REQUIRE(usage.liveSlots == 0);
+        REQUIRE(usage.deadSlots >= 10);
+        REQUIRE(usage.liveBytes < liveBytes);
+    }
+}
+
+TEST_CASE("Property and Binding memory usage")
+{
+    SUBCASE("A Property includes the memory of its connections")
+    {
+        Property<int> property(1);
+        const auto unconnected = property.memoryUsage();
+        REQUIRE(unconnected.liveBytes == sizeof(Property<int>));
+
+        auto handle = property.valueChanged().connect([](int) {});
+        REQUIRE(property.memoryUsage().liveBytes > unconnected.liveBytes);
+        handle.disconnect();
+    }
+
+    SUBCASE("A bound Property includes the memory of its Binding")
+    {
+        Property<int> a(1);
+        Property<int> b(2);
+        auto bound = makeBoundProperty(a + b * 2);
+
+        const auto usage = bound.memoryUsage();
+        REQUIRE(usage.liveBytes > sizeof(Property<int>) + sizeof(Binding<int>));
+    }
+
+    SUBCASE("A BindingEvaluator reports one slot per Binding")
+    {
+        BindingEvaluator evaluator;
+        Property<int> a(1);
+        auto bound = makeBoundProperty(evaluator, a * 2);
+        auto bound2 = makeBoundProperty(evaluator, a * 3);
+
+        REQUIRE(evaluator.memoryUsage().liveSlots == 2);
+    }
+
+    SUBCASE("A ConnectionEvaluator reports queued invocations")
+    {
+        auto evaluator = std::make_shared<ConnectionEvaluator>();
+        Signal<int> signal;
+        auto handle = signal.connectDeferred(evaluator, [](int) {});
+
+        signal.emit(1);
+        signal.emit(2);
+        REQUIRE(evaluator->memoryUsage().liveSlots == 2);
+
+        evaluator->evaluateDeferredConnections();
+        const auto usage = evaluator->memoryUsage();
+        REQUIRE(usage.liveSlots == 0);
+        REQUIRE(usage.deadSlots >= 2);
+    }
+}
+
+TEST_CASE("Process-wide memory tracking")
+{
+    const auto before = trackedMemoryUsage();
+    {
+        Signal<int> signal;
+        auto handle = signal.connect([](int) {});
+        REQUIRE(trackedMemoryUsage() > before);
+
+        Property<int> a(1);
+        auto bound = makeBoundProperty(a * 2);
+        REQUIRE(trackedMemoryUsage() > before);
+        handle.disconnect();
+    }
+    REQUIRE(trackedMemoryUsage() == before);
+}
+
+TEST_CASE("Stale ConnectionHandles don't keep connection storage alive")
+{
+    // A weak_ptr keeps the control block of a separately allocated object alive,
+    // but not the object itself.
+    std::size_t before = s_heapBytes;
+    std::weak_ptr<int> weakInt;
+    {
+        auto sharedInt = std::shared_ptr<int>(new int(1));
+        weakInt = sharedInt;
+    }
+    const std::size_t controlBlockBytes = s_heapBytes - before;
+    REQUIRE(controlBlockBytes > 0);
+
+    const auto trackedBefore = trackedMemoryUsage();
+    std::vector<ConnectionHandle> staleHandles;
+    staleHandles.reserve(100);
+    before = s_heapBytes;
+    {
+        Signal<int> signal;
+        for (int i = 0; i < 100; ++i) {
+            staleHandles.emplace_back(signal.connect([](int) {}));
+        }
+        REQUIRE(trackedMemoryUsage() > trackedBefore);
+    }
+
+    // Only the control block of the Signal's storage is kept alive by the handles
+    REQUIRE(trackedMemoryUsage() == trackedBefore);
+    REQUIRE(s_heapBytes - before == controlBlockBytes);
+    for (const auto &handle : staleHandles) {
+        REQUIRE_FALSE(handle.isActive());
+    }
+
+    staleHandles.clear();
+    REQUIRE(s_heapBytes == before);
+}